@@ -0,0 +1,47 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Measure the elapsed time
+class Timer {
+    std::chrono::steady_clock::time_point start_;
+
+ public:
+    Timer() : start_(std::chrono::steady_clock::now()) {
+    }
+
+    // Restart the measure
+    void reset() {
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    // Elapsed time in nanoseconds
+    int64_t elapsed_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_).count();
+    }
+};
+
+// Random numbers less than range, the same ones on every run
+class Random {
+    unsigned seed_;
+
+ public:
+    explicit Random(unsigned seed = 12345) : seed_(seed) {
+    }
+
+    int operator()(int range) {
+        seed_ = seed_ * 1103515245u + 12345u;
+        return static_cast<int>((((seed_ >> 8) & 0xffffffu) *
+                                 static_cast<uint64_t>(range)) >> 24);
+    }
+};
+
+// Keep the value alive so the compiler does not drop the measured code
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
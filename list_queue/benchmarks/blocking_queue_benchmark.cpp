@@ -0,0 +1,100 @@
+// Copyright 2020 for cpplint
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include "benchmarks/benchmark.h"
+#include "include/blocking_queue.h"
+#include "include/one_way_list.h"
+
+bool is_equal(const int64_t& data1, const int64_t& data2) {
+    return data1 == data2;
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Print the percentiles of count latencies in ns
+void report(const char* name, int capacity, int64_t* latencies, int count) {
+    std::sort(latencies, latencies + count);
+    auto at = [latencies, count](double share) {
+        return latencies[static_cast<int>(share * (count - 1))];
+    };
+    std::cout << name << "\t" << capacity << "\t" << at(0.5) << "\t" <<
+                 at(0.99) << "\t" << at(0.999) << "\t" << at(1.0) <<
+                 std::endl;
+}
+
+// One item at a time goes to the consumer and back
+// - the latency of a handoff is half of the round trip
+void ping_pong(int count) {
+    OneWayList<int64_t> ping_list(is_equal);
+    OneWayList<int64_t> pong_list(is_equal);
+    BlockingQueue<int64_t> ping(ping_list, 1);
+    BlockingQueue<int64_t> pong(pong_list, 1);
+    std::thread consumer([&ping, &pong]() {
+        int64_t data;
+        while (ping.pop(&data))
+            pong.push(data);
+    });
+    std::unique_ptr<int64_t[]> latencies(new int64_t[count]);
+    for (int i = 0; i < count; i++) {
+        int64_t start = now_ns();
+        ping.push(start);
+        int64_t data;
+        pong.pop(&data);
+        latencies[i] = (now_ns() - start) / 2;
+    }
+    ping.close();
+    consumer.join();
+    report("ping-pong", 1, latencies.get(), count);
+}
+
+// The producer pushes the time stamps as fast as the capacity allows,
+// the consumer measures the time from the push to the pop
+void stream(int count, int capacity, int batch) {
+    OneWayList<int64_t> list(is_equal);
+    BlockingQueue<int64_t> queue(list, capacity);
+    // the producer pushes whole batches, up to count + batch - 1 items
+    std::unique_ptr<int64_t[]> latencies(new int64_t[count + batch]);
+    int received = 0;
+    std::thread consumer([&queue, &latencies, &received, batch]() {
+        std::unique_ptr<int64_t[]> data(new int64_t[batch]);
+        while (int taken = queue.pop_bulk(data.get(), batch)) {
+            int64_t now = now_ns();
+            for (int i = 0; i < taken; i++)
+                latencies[received++] = now - data[i];
+        }
+    });
+    std::unique_ptr<int64_t[]> data(new int64_t[batch]);
+    Timer timer;
+    for (int i = 0; i < count; i += batch) {
+        int64_t start = now_ns();
+        std::fill(data.get(), data.get() + batch, start);
+        queue.push_bulk(data.get(), batch);
+    }
+    queue.close();
+    consumer.join();
+    int64_t elapsed = timer.elapsed_ns();
+    report(batch == 1 ? "stream" : "stream bulk", capacity, latencies.get(),
+           received);
+    std::cout << "\t" << static_cast<double>(received) / elapsed * 1e9
+              << " items/s" << std::endl;
+}
+
+int main() {
+    const int count = 200000;
+    std::cout << "mode\tcapacity\tp50 ns\tp99 ns\tp99.9 ns\tmax ns" <<
+                 std::endl;
+    ping_pong(count);
+    for (int capacity = 16; capacity <= 4096; capacity *= 16) {
+        stream(count, capacity, 1);
+        stream(count, capacity, 16);
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "benchmarks/benchmark.h"
+#include "include/queue.h"
+#include "include/one_way_list.h"
+#include "include/concurrent_queue.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Queue guarded by a global mutex
+class MutexQueue {
+    OneWayList<int> list_;
+    Queue<int> queue_;
+    std::mutex mutex_;
+
+ public:
+    MutexQueue() : list_(is_equal), queue_(list_) {
+    }
+
+    void enqueue(int data) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.enqueue(data);
+    }
+
+    bool try_dequeue(int* data) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.is_empty())
+            return false;
+        *data = queue_.dequeue();
+        return true;
+    }
+};
+
+// Run threads doing enqueue and dequeue pairs - return operations per second
+template<typename Q>
+double run(int threads, int count) {
+    Q queue;
+    std::unique_ptr<std::thread[]> workers(new std::thread[threads]);
+    Timer timer;
+    for (int t = 0; t < threads; t++) {
+        workers[t] = std::thread([&queue, count]() {
+            int data = 0;
+            int64_t sum = 0;
+            for (int i = 0; i < count; i++) {
+                queue.enqueue(i);
+                if (queue.try_dequeue(&data))
+                    sum += data;
+            }
+            do_not_optimize(sum);
+        });
+    }
+    for (int t = 0; t < threads; t++)
+        workers[t].join();
+    int64_t elapsed = timer.elapsed_ns();
+    return 2.0 * threads * count / elapsed * 1e9;
+}
+
+int main() {
+    const int count = 1000000;
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores < 1)
+        cores = 1;
+    std::cout << "threads\tConcurrentQueue, ops/s\tmutex Queue, ops/s" <<
+                 std::endl;
+    for (int threads = 1; threads <= cores; threads++) {
+        std::cout << threads << "\t" <<
+                     run<ConcurrentQueue<int>>(threads, count) << "\t" <<
+                     run<MutexQueue>(threads, count) << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <functional>
+#include "benchmarks/benchmark.h"
+#include "include/queue.h"
+#include "include/deque.h"
+#include "include/priority_queue.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Run random adds and takes on a queue holding about size items
+// - ns per operation
+// add(data) adds the data and take() takes an item out
+template<typename Add, typename Take>
+void measure(const char* name, int size, int operations, Add add,
+             Take take) {
+    const int kRange = 1 << 24;
+    Random random;
+    for (int i = 0; i < size; i++)
+        add(random(kRange));
+    int64_t sum = 0;
+    int count = size;
+    Timer timer;
+    for (int i = 0; i < operations; i++) {
+        int data = random(kRange);
+        // even numbers add, odd numbers take
+        if (data % 2 == 0 || count == 0) {
+            add(data);
+            count++;
+        } else {
+            sum += take(data);
+            count--;
+        }
+    }
+    int64_t elapsed = timer.elapsed_ns();
+    do_not_optimize(sum);
+    std::cout << name << "\t" << size << "\t" <<
+                 static_cast<double>(elapsed) / operations << std::endl;
+}
+
+int main() {
+    const int kOperations = 2000000;
+    std::cout << "queue\tsize\tns per operation" << std::endl;
+    for (int size = 1000; size <= 1000000; size *= 10) {
+        {
+            OneWayList<int> list(is_equal);
+            Queue<int> queue(list);
+            measure("Queue", size, kOperations,
+                    [&queue](int data) { queue.enqueue(data); },
+                    [&queue](int) { return queue.dequeue(); });
+        }
+        {
+            TwoWayList<int> list(is_equal);
+            Deque<int> deque(list);
+            // the data choose the end
+            measure("Deque", size, kOperations,
+                    [&deque](int data) {
+                        if (data & 4)
+                            deque.push_front(data);
+                        else
+                            deque.push_back(data);
+                    },
+                    [&deque](int data) {
+                        return data & 4 ? deque.pop_front() :
+                                          deque.pop_back();
+                    });
+        }
+        {
+            PriorityQueue<int> queue;
+            measure("PriorityQueue", size, kOperations,
+                    [&queue](int data) { queue.enqueue(data); },
+                    [&queue](int) { return queue.dequeue(); });
+        }
+    }
+    return 0;
+}
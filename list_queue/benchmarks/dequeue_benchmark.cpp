@@ -0,0 +1,96 @@
+// Copyright 2020 for cpplint
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include "benchmarks/benchmark.h"
+#include "include/queue.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+#include "include/unrolled_list.h"
+#include "include/ring_buffer.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Print the percentiles of the sorted latencies
+void report(const char* name, int64_t* latencies, int count) {
+    std::sort(latencies, latencies + count);
+    const double percents[] = {50, 90, 99, 99.9};
+    std::cout << name;
+    for (double percent : percents) {
+        int index = static_cast<int>(percent / 100 * (count - 1));
+        std::cout << "\t" << latencies[index];
+    }
+    std::cout << "\t" << latencies[count - 1] << std::endl;
+}
+
+// the number of dequeues measured together, a single dequeue is shorter
+// than the clock resolution
+const int kBatch = 32;
+
+// Fill the list and measure the dequeues - per dequeue latency of batches
+void measure(const char* name, List<int>& list, int count) {
+    Queue<int> queue(list);
+    for (int i = 0; i < count; i++)
+        queue.enqueue(i);
+    int batches = count / kBatch;
+    std::unique_ptr<int64_t[]> latencies(new int64_t[batches]);
+    int64_t sum = 0;
+    for (int i = 0; i < batches; i++) {
+        Timer timer;
+        for (int j = 0; j < kBatch; j++)
+            sum += queue.dequeue();
+        latencies[i] = timer.elapsed_ns() / kBatch;
+    }
+    do_not_optimize(sum);
+    report(name, latencies.get(), batches);
+}
+
+// Measure the old dequeue path - get_first and erase_by_index(0)
+void measure_erase(const char* name, List<int>& list, int count) {
+    for (int i = 0; i < count; i++)
+        list.push(i);
+    int batches = count / kBatch;
+    std::unique_ptr<int64_t[]> latencies(new int64_t[batches]);
+    int64_t sum = 0;
+    for (int i = 0; i < batches; i++) {
+        Timer timer;
+        for (int j = 0; j < kBatch; j++) {
+            sum += list.get_first();
+            list.erase_by_index(0);
+        }
+        latencies[i] = timer.elapsed_ns() / kBatch;
+    }
+    do_not_optimize(sum);
+    report(name, latencies.get(), batches);
+}
+
+int main() {
+    const int count = 1000000;
+    std::cout << "dequeue latency, ns (average of " << kBatch <<
+                 " dequeues)" << std::endl;
+    std::cout << "backend\tp50\tp90\tp99\tp99.9\tmax" << std::endl;
+    {
+        OneWayList<int> list(is_equal);
+        measure_erase("OneWayList erase_by_index(0)", list, count);
+    }
+    {
+        OneWayList<int> list(is_equal);
+        measure("OneWayList pop_front", list, count);
+    }
+    {
+        TwoWayList<int> list(is_equal);
+        measure("TwoWayList pop_front", list, count);
+    }
+    {
+        UnrolledList<int> list(is_equal);
+        measure("UnrolledList pop_front", list, count);
+    }
+    {
+        RingBuffer<int> list(is_equal, count);
+        measure("RingBuffer pop_front", list, count);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Measure at and erase_by_index at random positions, and pairs of
+// emplace_front and at - ns per operation
+template<typename L>
+void measure(const char* name, L& list, int count, int operations) {
+    for (int i = 0; i < count; i++)
+        list.push(i);
+    Random random;
+    int64_t sum = 0;
+    Timer timer;
+    for (int i = 0; i < operations; i++)
+        sum += list.at(random(count));
+    int64_t at_ns = timer.elapsed_ns() / operations;
+    timer.reset();
+    for (int i = 0; i < operations; i++)
+        list.erase_by_index(random(list.size()));
+    int64_t erase_ns = timer.elapsed_ns() / operations;
+    timer.reset();
+    for (int i = 0; i < operations; i++) {
+        list.emplace_front(i);
+        sum += list.at(random(list.size()));
+    }
+    int64_t front_ns = timer.elapsed_ns() / operations;
+    do_not_optimize(sum);
+    std::cout << name << "\t" << count << "\t" << at_ns << "\t" <<
+                 erase_ns << "\t" << front_ns << std::endl;
+}
+
+int main() {
+    std::cout << "indexed access, ns per operation" << std::endl;
+    std::cout << "list\tsize\tat\terase_by_index\templace_front+at" <<
+                 std::endl;
+    const int sizes[] = {1000, 100000, 1000000};
+    for (int count : sizes) {
+        // the scans take O(n), fewer operations on long lists
+        int operations = count >= 100000 ? 200 : count / 2;
+        {
+            OneWayList<int> list(is_equal);
+            measure("OneWayList", list, count, operations);
+        }
+        {
+            OneWayList<int> list(is_equal);
+            list.enable_block_index();
+            measure("OneWayList indexed", list, count, operations);
+        }
+        {
+            TwoWayList<int> list(is_equal);
+            measure("TwoWayList", list, count, operations);
+        }
+        {
+            TwoWayList<int> list(is_equal);
+            list.enable_block_index();
+            measure("TwoWayList indexed", list, count, operations);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <memory>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/node_pool.h"
+#include "include/intrusive_list.h"
+
+// Pre-allocated object to queue
+struct Job {
+    int64_t id_;
+    IntrusiveHook<Job> hook_;
+};
+
+bool is_same_job(Job* const& job1, Job* const& job2) {
+    return job1 == job2;
+}
+
+// Move the jobs through the queue in rounds - ns per push and pop
+// every round pushes all jobs and pops them again
+template<typename Push, typename Pop>
+void measure(const char* name, Job* jobs, int count, int rounds,
+             Push push, Pop pop) {
+    int64_t sum = 0;
+    Timer timer;
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < count; i++)
+            push(jobs + i);
+        for (int i = 0; i < count; i++)
+            sum += pop()->id_;
+    }
+    int64_t elapsed = timer.elapsed_ns();
+    do_not_optimize(sum);
+    std::cout << name << "\t" << count << "\t" <<
+                 static_cast<double>(elapsed) / count / rounds << std::endl;
+}
+
+int main() {
+    std::cout << "queue\tjobs\tns per push and pop" << std::endl;
+    for (int count = 1000; count <= 1000000; count *= 10) {
+        int rounds = 10000000 / count;
+        std::unique_ptr<Job[]> jobs(new Job[count]);
+        for (int i = 0; i < count; i++)
+            jobs[i].id_ = i;
+        {
+            OneWayList<Job*> list(is_same_job);
+            measure("OneWayList<Job*>", jobs.get(), count, rounds,
+                    [&list](Job* job) { list.push(job); },
+                    [&list]() { return list.pop_front(); });
+        }
+        {
+            typedef OneWayList<Job*, PoolAllocator> PoolList;
+            NodePool<PoolList::Node> pool;
+            PoolList list(is_same_job, pool);
+            measure("OneWayList<Job*>, pool", jobs.get(), count, rounds,
+                    [&list](Job* job) { list.push(job); },
+                    [&list]() { return list.pop_front(); });
+        }
+        {
+            IntrusiveOneWayList<Job, &Job::hook_> list;
+            measure("IntrusiveOneWayList", jobs.get(), count, rounds,
+                    [&list](Job* job) { list.push(job); },
+                    [&list]() { return list.pop_front(); });
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+// Copyright 2020 for cpplint
+
+#include <algorithm>
+#include <iostream>
+#include <functional>
+#include <thread>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/unrolled_list.h"
+#include "include/thread_pool.h"
+
+// Measure parallel_count and parallel_apply with the pool - ms per pass
+template<typename L>
+void measure(const char* name, L& list, ThreadPool& pool, int repeat) {
+    int found = 0;
+    Timer timer;
+    for (int i = 0; i < repeat; i++)
+        found += list.parallel_count(pool, 7);
+    int64_t count_ns = timer.elapsed_ns() / repeat;
+    do_not_optimize(found);
+    timer.reset();
+    for (int i = 0; i < repeat; i++) {
+        // some work per data, the callback must not share a counter
+        list.parallel_apply(pool, [](const int& data) {
+            int64_t hash = data;
+            for (int j = 0; j < 8; j++)
+                hash = hash * 6364136223846793005ll + 1442695040888963407ll;
+            do_not_optimize(hash);
+        });
+    }
+    int64_t apply_ns = timer.elapsed_ns() / repeat;
+    std::cout << name << "\t" << pool.size() << "\t" <<
+                 count_ns / 1000000.0 << "\t" << apply_ns / 1000000.0 <<
+                 std::endl;
+}
+
+int main() {
+    typedef std::equal_to<int> Equal;
+    const int kCount = 10000000;
+    const int kRepeat = 5;
+    OneWayList<int, HeapAllocator, Equal> list((Equal()));
+    UnrolledList<int, Equal> unrolled((Equal()));
+    for (int i = 0; i < kCount; i++) {
+        list.push(i % 100);
+        unrolled.push(i % 100);
+    }
+    list.enable_block_index();
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    if (hardware < 1)
+        hardware = 1;
+    std::cout << kCount << " items, ms per pass" << std::endl;
+    std::cout << "list\tthreads\tcount\tapply" << std::endl;
+    // double the threads, the last step goes to all hardware threads
+    for (int threads = 1; ; threads = std::min(threads * 2, hardware)) {
+        ThreadPool pool(threads);
+        measure("OneWayList", list, pool, kRepeat);
+        measure("UnrolledList", unrolled, pool, kRepeat);
+        if (threads == hardware)
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Copyright 2020 for cpplint
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include "benchmarks/benchmark.h"
+#include "include/persistent_queue.h"
+
+// Record of a message log
+struct Record {
+    int64_t id;
+    int64_t time;
+    double value;
+    int32_t source;
+    int32_t flags;
+};
+
+// Delete the files of the directory
+void remove_files(const std::string& directory) {
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.')
+            unlink((directory + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+int main() {
+    const int count = 5000000;
+    const int batch = 256;
+    char name[] = "/tmp/persistent_queue_XXXXXX";
+    std::string path = std::string(mkdtemp(name)) + "/queue";
+    std::unique_ptr<Record[]> records(new Record[batch]);
+    for (int i = 0; i < batch; i++)
+        records[i] = Record{i, i, i * 0.5, i % 7, 0};
+    std::cout << "operation\tns per item" << std::endl;
+    int64_t sum = 0;
+    {
+        PersistentQueue<Record> queue(path);
+        Timer timer;
+        for (int i = 0; i < count; i++)
+            queue.enqueue(records[i % batch]);
+        std::cout << "enqueue\t" <<
+                     static_cast<double>(timer.elapsed_ns()) / count <<
+                     std::endl;
+        timer.reset();
+        for (int i = 0; i < count; i++)
+            sum += queue.dequeue().id;
+        std::cout << "dequeue\t" <<
+                     static_cast<double>(timer.elapsed_ns()) / count <<
+                     std::endl;
+        timer.reset();
+        for (int i = 0; i < count; i += batch)
+            queue.enqueue_bulk(records.get(), batch);
+        std::cout << "enqueue_bulk\t" <<
+                     static_cast<double>(timer.elapsed_ns()) / count <<
+                     std::endl;
+        timer.reset();
+        queue.sync();
+        std::cout << "sync of " << queue.size() << " items, ms\t" <<
+                     timer.elapsed_ns() / 1000000 << std::endl;
+    }
+    {
+        // opening reads the segment headers only
+        Timer timer;
+        PersistentQueue<Record> queue(path);
+        std::cout << "open with " << queue.size() << " items, us\t" <<
+                     timer.elapsed_ns() / 1000 << std::endl;
+        timer.reset();
+        int64_t taken = 0;
+        while (int got = queue.dequeue_bulk(records.get(), batch)) {
+            sum += records[0].id;
+            taken += got;
+        }
+        std::cout << "dequeue_bulk\t" <<
+                     static_cast<double>(timer.elapsed_ns()) / taken <<
+                     std::endl;
+    }
+    do_not_optimize(sum);
+    remove_files(path);
+    rmdir(name);
+    return 0;
+}
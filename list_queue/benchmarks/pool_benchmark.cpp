@@ -0,0 +1,57 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+#include "include/node_pool.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Keep depth items in the list and pass count items through it
+// - return the time in nanoseconds
+int64_t churn(List<int>& list, int depth, int count) {
+    for (int i = 0; i < depth; i++)
+        list.push(i);
+    Timer timer;
+    for (int i = 0; i < count; i++) {
+        list.push(i);
+        list.erase_by_index(0);
+    }
+    return timer.elapsed_ns();
+}
+
+void report(const char* name, int depth, int count, int64_t elapsed) {
+    std::cout << name << "\t" << depth << "\t" <<
+                 static_cast<double>(elapsed) / count << std::endl;
+}
+
+int main() {
+    const int count = 10000000;
+    std::cout << "list\tdepth\tper enqueue+dequeue, ns" << std::endl;
+    for (int depth = 10; depth <= 1000000; depth *= 100) {
+        {
+            OneWayList<int> list(is_equal);
+            report("OneWayList heap", depth, count, churn(list, depth, count));
+        }
+        {
+            NodePool<OneWayList<int, PoolAllocator>::Node> pool;
+            OneWayList<int, PoolAllocator> list(is_equal, pool);
+            report("OneWayList pool", depth, count, churn(list, depth, count));
+            std::cout << "\tpooled " << pool.pooled() << ", reused " <<
+                         pool.reused() << std::endl;
+        }
+        {
+            TwoWayList<int> list(is_equal);
+            report("TwoWayList heap", depth, count, churn(list, depth, count));
+        }
+        {
+            NodePool<TwoWayList<int, PoolAllocator>::Node> pool;
+            TwoWayList<int, PoolAllocator> list(is_equal, pool);
+            report("TwoWayList pool", depth, count, churn(list, depth, count));
+        }
+    }
+    return 0;
+}
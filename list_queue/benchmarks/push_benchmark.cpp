@@ -0,0 +1,32 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include "benchmarks/benchmark.h"
+#include "include/queue.h"
+#include "include/one_way_list.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Fill the queue with count items - return the time in nanoseconds
+int64_t fill_queue(int count) {
+    OneWayList<int> one_list(is_equal);
+    Queue<int> queue(one_list);
+    Timer timer;
+    for (int i = 0; i < count; i++)
+        queue.enqueue(i);
+    int64_t elapsed = timer.elapsed_ns();
+    do_not_optimize(one_list.get_first());
+    return elapsed;
+}
+
+int main() {
+    std::cout << "items\ttotal, ms\tper item, ns" << std::endl;
+    for (int count = 1000; count <= 10000000; count *= 10) {
+        int64_t elapsed = fill_queue(count);
+        std::cout << count << "\t" << elapsed / 1000000.0 << "\t" <<
+                     static_cast<double>(elapsed) / count << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <functional>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+#include "include/unrolled_list.h"
+
+// Fill the list and measure find and apply over it
+template<typename L>
+void scan(const char* name, L& list, int count, int repeat) {
+    for (int i = 0; i < count; i++)
+        list.push(i % 100);
+    int64_t items = static_cast<int64_t>(count) * repeat;
+    int found = 0;
+    Timer timer;
+    for (int i = 0; i < repeat; i++)
+        found += list.find(7);
+    int64_t find_ns = timer.elapsed_ns();
+    do_not_optimize(found);
+    int64_t sum = 0;
+    timer.reset();
+    for (int i = 0; i < repeat; i++)
+        list.apply([&sum](const int& data) { sum += data; });
+    int64_t apply_ns = timer.elapsed_ns();
+    do_not_optimize(sum);
+    std::cout << name << "\t" << count << "\t" <<
+                 static_cast<double>(find_ns) / items << "\t" <<
+                 static_cast<double>(apply_ns) / items << std::endl;
+}
+
+int main() {
+    typedef std::equal_to<int> Equal;
+    std::cout << "list\titems\tfind, ns per item\tapply, ns per item" <<
+                 std::endl;
+    for (int count = 1000; count <= 10000000; count *= 10) {
+        int repeat = 10000000 / count;
+        {
+            OneWayList<int, HeapAllocator, Equal> list((Equal()));
+            scan("OneWayList", list, count, repeat);
+        }
+        {
+            TwoWayList<int, HeapAllocator, Equal> list((Equal()));
+            scan("TwoWayList", list, count, repeat);
+        }
+        {
+            UnrolledList<int, Equal> list((Equal()));
+            scan("UnrolledList", list, count, repeat);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <functional>
+#include <memory>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/unrolled_list.h"
+#include "include/simd_count.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Print the speed of find in GB of data per second
+void report(const char* name, int64_t items, int64_t elapsed, int found) {
+    do_not_optimize(found);
+    std::cout << name << "\t" <<
+                 static_cast<double>(items) * sizeof(int) / elapsed <<
+                 std::endl;
+}
+
+// Fill the list and measure find over it
+template<typename L>
+void scan(const char* name, L& list, int count, int repeat) {
+    for (int i = 0; i < count; i++)
+        list.push(i % 100);
+    int found = 0;
+    Timer timer;
+    for (int i = 0; i < repeat; i++)
+        found += list.find(7);
+    report(name, static_cast<int64_t>(count) * repeat, timer.elapsed_ns(),
+           found);
+}
+
+int main() {
+    typedef std::equal_to<int> Equal;
+#if defined(__AVX2__)
+    std::cout << "find with AVX2, GB per second" << std::endl;
+#elif defined(__SSE2__)
+    std::cout << "find with SSE2, GB per second" << std::endl;
+#else
+    std::cout << "find without SIMD, GB per second" << std::endl;
+#endif
+    for (int count = 1000; count <= 10000000; count *= 100) {
+        int repeat = 100000000 / count;
+        std::cout << "------ " << count << " items ------" << std::endl;
+        {
+            OneWayList<int> list(is_equal);
+            scan("OneWayList, std::function", list, count, repeat / 10);
+        }
+        {
+            OneWayList<int, HeapAllocator, Equal> list((Equal()));
+            scan("OneWayList, std::equal_to", list, count, repeat / 10);
+        }
+        {
+            UnrolledList<int> list(is_equal);
+            scan("UnrolledList, std::function", list, count, repeat);
+        }
+        {
+            UnrolledList<int, Equal> list((Equal()));
+            scan("UnrolledList, SIMD", list, count, repeat);
+        }
+        {
+            // bulk snapshot of the data
+            std::unique_ptr<int[]> data(new int[count]);
+            for (int i = 0; i < count; i++)
+                data[i] = i % 100;
+            int found = 0;
+            Timer timer;
+            for (int i = 0; i < repeat; i++)
+                found += count_equal(data.get(), count, 7);
+            report("array, SIMD", static_cast<int64_t>(count) * repeat,
+                   timer.elapsed_ns(), found);
+        }
+    }
+    return 0;
+}
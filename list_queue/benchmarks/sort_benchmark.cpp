@@ -0,0 +1,79 @@
+// Copyright 2020 for cpplint
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Fill the list with count random data less than range
+template<typename L>
+void fill(L* list, int count, int range, unsigned seed) {
+    Random random(seed);
+    for (int i = 0; i < count; i++)
+        list->push(random(range));
+}
+
+// Sort by copying the data to an array, sorting it and pushing it back
+// to new items, the way without sort()
+template<typename L>
+void sort_by_copy(L* list, int count) {
+    std::unique_ptr<int[]> data(new int[count]);
+    int size = 0;
+    list->apply([&data, &size](const int& item) { data[size++] = item; });
+    std::stable_sort(data.get(), data.get() + size);
+    list->clear();
+    list->push_range(data.get(), size);
+}
+
+// Measure sort, merge and unique - print ms of each
+template<typename L>
+void measure(const char* name, int count) {
+    int64_t sort_ms;
+    int64_t copy_ms;
+    int64_t merge_ms;
+    int64_t unique_ms;
+    {
+        L list(is_equal);
+        fill(&list, count, count, 1);
+        Timer timer;
+        list.sort();
+        sort_ms = timer.elapsed_ns() / 1000000;
+        L other(is_equal);
+        fill(&other, count, count, 2);
+        other.sort();
+        timer.reset();
+        list.merge(std::move(other));
+        merge_ms = timer.elapsed_ns() / 1000000;
+        timer.reset();
+        list.unique();
+        unique_ms = timer.elapsed_ns() / 1000000;
+    }
+    {
+        L list(is_equal);
+        fill(&list, count, count, 1);
+        Timer timer;
+        sort_by_copy(&list, count);
+        copy_ms = timer.elapsed_ns() / 1000000;
+        do_not_optimize(list.get_first());
+    }
+    std::cout << name << "\t" << count << "\t" << sort_ms << "\t" <<
+                 copy_ms << "\t" << merge_ms << "\t" << unique_ms <<
+                 std::endl;
+}
+
+int main() {
+    std::cout << "list\tsize\tsort, ms\tcopy and std::stable_sort, ms\t"
+                 "merge, ms\tunique, ms" << std::endl;
+    for (int count = 1000000; count <= 10000000; count *= 10) {
+        measure<OneWayList<int>>("OneWayList", count);
+        measure<TwoWayList<int>>("TwoWayList", count);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Copyright 2020 for cpplint
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include "benchmarks/benchmark.h"
+#include "include/queue.h"
+#include "include/spill_queue.h"
+#include "include/two_way_list.h"
+
+// Record of a message log
+struct Record {
+    int64_t id;
+    int64_t time;
+    double value;
+    int32_t source;
+    int32_t flags;
+
+    bool operator==(const Record& rhs) const {
+        return id == rhs.id;
+    }
+};
+
+bool is_equal(const Record& data1, const Record& data2) {
+    return data1 == data2;
+}
+
+// Fill the queue to length items, then run pairs of enqueue and dequeue
+// - print items per second of the pairs
+// add(id) adds a record, take() takes one out and returns its id
+template<typename Add, typename Take>
+void measure(const char* name, int length, int pairs, Add add, Take take) {
+    Timer timer;
+    for (int i = 0; i < length; i++)
+        add(i);
+    int64_t fill_ns = timer.elapsed_ns();
+    int64_t sum = 0;
+    timer.reset();
+    for (int i = 0; i < pairs; i++) {
+        add(length + i);
+        sum += take();
+    }
+    int64_t elapsed = timer.elapsed_ns();
+    do_not_optimize(sum);
+    std::cout << name << "\t" << length << "\t" <<
+                 static_cast<double>(length) / fill_ns * 1e9 << "\t" <<
+                 2.0 * pairs / elapsed * 1e9 << std::endl;
+}
+
+int main() {
+    const int budget = 100000;
+    const int length = 10 * budget;
+    const int pairs = 5000000;
+    char name[] = "/tmp/spill_queue_XXXXXX";
+    std::string directory = mkdtemp(name);
+    std::cout << "queue\tlength\tfill, items/s\tsustained, items/s" <<
+                 std::endl;
+    {
+        TwoWayList<Record> list(is_equal);
+        SpillQueue<Record> queue(list, directory, budget);
+        measure("SpillQueue", length, pairs,
+                [&queue](int64_t id) {
+                    queue.enqueue(Record{id, id, 0.5, 1, 0});
+                },
+                [&queue]() { return queue.dequeue().id; });
+        std::cout << "in memory " << list.size() << " of " <<
+                     queue.size() << " items" << std::endl;
+    }
+    {
+        TwoWayList<Record> list(is_equal);
+        Queue<Record> queue(list);
+        measure("Queue", length, pairs,
+                [&queue](int64_t id) {
+                    queue.enqueue(Record{id, id, 0.5, 1, 0});
+                },
+                [&queue]() { return queue.dequeue().id; });
+    }
+    rmdir(directory.c_str());
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <functional>
+#include "benchmarks/benchmark.h"
+#include "include/queue.h"
+#include "include/static_queue.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+// Enqueue and dequeue through the queue - ns per operation
+// the queue holds a few items, so the list stays in the cache
+template<typename Q>
+void measure(const char* name, Q& queue, int operations) {
+    for (int i = 0; i < 16; i++)
+        queue.enqueue(i);
+    int64_t sum = 0;
+    Timer timer;
+    for (int i = 0; i < operations; i++) {
+        queue.enqueue(i);
+        sum += queue.dequeue();
+    }
+    int64_t elapsed = timer.elapsed_ns();
+    do_not_optimize(sum);
+    // every step is an enqueue and a dequeue
+    std::cout << name << "\t" <<
+                 static_cast<double>(elapsed) / (2.0 * operations) << std::endl;
+}
+
+int main() {
+    typedef std::equal_to<int> Equal;
+    typedef OneWayList<int, HeapAllocator, Equal> OneList;
+    typedef TwoWayList<int, HeapAllocator, Equal> TwoList;
+    const int kOperations = 10000000;
+    std::cout << "queue\tns per operation" << std::endl;
+    {
+        OneList list((Equal()));
+        Queue<int> queue(list);
+        measure("Queue, OneWayList", queue, kOperations);
+    }
+    {
+        OneList list((Equal()));
+        StaticQueue<int, OneList> queue(list);
+        measure("StaticQueue, OneWayList", queue, kOperations);
+    }
+    {
+        TwoList list((Equal()));
+        Queue<int> queue(list);
+        measure("Queue, TwoWayList", queue, kOperations);
+    }
+    {
+        TwoList list((Equal()));
+        StaticQueue<int, TwoList> queue(list);
+        measure("StaticQueue, TwoWayList", queue, kOperations);
+    }
+    return 0;
+}
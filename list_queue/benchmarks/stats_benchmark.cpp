@@ -0,0 +1,53 @@
+// Copyright 2020 for cpplint
+
+#include <functional>
+#include <iostream>
+#include "benchmarks/benchmark.h"
+#include "include/list_stats.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+typedef std::function<bool(const int&, const int&)> Equal;
+
+// Measure push and pop_front pairs on a list of size items and find
+// - print ns per operation
+template<typename L>
+void measure(const char* name, int size, int operations) {
+    L list(is_equal);
+    for (int i = 0; i < size; i++)
+        list.push(i);
+    int64_t sum = 0;
+    Timer timer;
+    for (int i = 0; i < operations; i++) {
+        list.push(i);
+        sum += list.pop_front();
+    }
+    int64_t push_pop_ns = timer.elapsed_ns();
+    int finds = operations / size + 1;
+    timer.reset();
+    for (int i = 0; i < finds; i++)
+        sum += list.find(i % size);
+    int64_t find_ns = timer.elapsed_ns();
+    do_not_optimize(sum);
+    std::cout << name << "\t" << size << "\t" <<
+                 static_cast<double>(push_pop_ns) / operations << "\t" <<
+                 static_cast<double>(find_ns) / finds << std::endl;
+}
+
+int main() {
+    const int operations = 5000000;
+    std::cout << "list\tsize\tpush and pop_front, ns\tfind, ns" << std::endl;
+    for (int size = 10; size <= 100000; size *= 100) {
+        measure<OneWayList<int>>("OneWayList", size, operations);
+        measure<OneWayList<int, HeapAllocator, Equal, ListStats>>(
+                "OneWayList with stats", size, operations);
+        measure<TwoWayList<int>>("TwoWayList", size, operations);
+        measure<TwoWayList<int, HeapAllocator, Equal, ListStats>>(
+                "TwoWayList with stats", size, operations);
+    }
+    return 0;
+}
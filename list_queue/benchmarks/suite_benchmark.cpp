@@ -0,0 +1,220 @@
+// Copyright 2020 for cpplint
+
+// Benchmarks of every list and queue operation for several payloads and
+// sizes, the results are printed as JSON to compare them from run to run
+// usage: benchmarks [max_size] > results.json
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include "benchmarks/benchmark.h"
+#include "include/queue.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+// Movable data without copies, like Foo in the tests
+class Movable {
+    int a_;
+
+ public:
+    explicit Movable(int a) : a_(a) {
+    }
+
+    Movable(Movable&&) = default;
+    Movable& operator=(Movable&&) = default;
+
+    bool operator==(const Movable& rhs) const {
+        return a_ == rhs.a_;
+    }
+
+    int key() const {
+        return a_;
+    }
+};
+
+// Making, comparing and reading the payloads of each type
+template<typename T>
+struct Payload;
+
+template<>
+struct Payload<int> {
+    static const char* name() {
+        return "int";
+    }
+    static int make(int key) {
+        return key;
+    }
+    static int key(const int& data) {
+        return data;
+    }
+    static bool equal(const int& data1, const int& data2) {
+        return data1 == data2;
+    }
+};
+
+template<>
+struct Payload<Movable> {
+    static const char* name() {
+        return "movable";
+    }
+    static Movable make(int key) {
+        return Movable(key);
+    }
+    static int key(const Movable& data) {
+        return data.key();
+    }
+    static bool equal(const Movable& data1, const Movable& data2) {
+        return data1 == data2;
+    }
+};
+
+template<>
+struct Payload<std::unique_ptr<int>> {
+    static const char* name() {
+        return "unique_ptr";
+    }
+    static std::unique_ptr<int> make(int key) {
+        return std::make_unique<int>(key);
+    }
+    static int key(const std::unique_ptr<int>& data) {
+        return *data;
+    }
+    static bool equal(const std::unique_ptr<int>& data1,
+                      const std::unique_ptr<int>& data2) {
+        return *data1 == *data2;
+    }
+};
+
+// Prints the results as a JSON array of objects
+class Report {
+    bool first_;
+
+ public:
+    Report() : first_(true) {
+        std::cout << "[";
+    }
+
+    ~Report() {
+        std::cout << "\n]" << std::endl;
+    }
+
+    // Add the result of operations calls taking elapsed ns in total
+    void add(const char* list, const char* payload, const char* operation,
+             int size, int64_t operations, int64_t elapsed) {
+        std::cout << (first_ ? "\n" : ",\n") <<
+                     "  {\"list\": \"" << list <<
+                     "\", \"payload\": \"" << payload <<
+                     "\", \"operation\": \"" << operation <<
+                     "\", \"size\": " << size <<
+                     ", \"operations\": " << operations <<
+                     ", \"ns_per_op\": " <<
+                     static_cast<double>(elapsed) / operations << "}";
+        first_ = false;
+    }
+};
+
+// The number of calls of an operation taking O(size), about the same
+// total time for every size
+int scans(int size) {
+    const int64_t kWork = 20000000;
+    int64_t calls = kWork / size;
+    return calls < 1 ? 1 : calls > 100000 ? 100000 : static_cast<int>(calls);
+}
+
+// Measure the operations common to both lists
+template<typename L, typename T>
+void measure_list(const char* name, int size, Report* report) {
+    using P = Payload<T>;
+    Random random;
+    L list(P::equal);
+    Timer timer;
+    for (int i = 0; i < size; i++)
+        list.push(P::make(i));
+    report->add(name, P::name(), "push", size, size, timer.elapsed_ns());
+
+    int calls = scans(size);
+    int64_t sum = 0;
+    timer.reset();
+    for (int i = 0; i < calls; i++)
+        sum += list.find(P::make(random(size)));
+    report->add(name, P::name(), "find", size, calls, timer.elapsed_ns());
+
+    timer.reset();
+    for (int i = 0; i < calls; i++)
+        list.apply([&sum](const T& data) { sum += P::key(data); });
+    report->add(name, P::name(), "apply", size, calls, timer.elapsed_ns());
+
+    // keep the size, each erased item is pushed again
+    timer.reset();
+    for (int i = 0; i < calls; i++) {
+        list.erase_by_index(random(size));
+        list.push(P::make(size + i));
+    }
+    report->add(name, P::name(), "erase_by_index", size, calls,
+                timer.elapsed_ns());
+
+    // the values from 0 to size - 1 may have been erased already
+    timer.reset();
+    for (int i = 0; i < calls; i++) {
+        list.erase_by_value(P::make(random(size)));
+        if (list.size() < size)
+            list.push(P::make(size + calls + i));
+    }
+    report->add(name, P::name(), "erase_by_value", size, calls,
+                timer.elapsed_ns());
+
+    // a pair of enqueue and dequeue is an operation
+    Queue<T> queue(list);
+    int pairs = size < 1000000 ? 1000000 : size;
+    timer.reset();
+    for (int i = 0; i < pairs; i++) {
+        queue.enqueue(P::make(i));
+        sum += P::key(queue.dequeue());
+    }
+    report->add(name, P::name(), "enqueue_dequeue", size, pairs,
+                timer.elapsed_ns());
+    do_not_optimize(sum);
+}
+
+// Measure the operations of TwoWayList only
+template<typename T>
+void measure_two_way(int size, Report* report) {
+    using P = Payload<T>;
+    const char* name = "TwoWayList";
+    TwoWayList<T> list(P::equal);
+    Timer timer;
+    for (int i = 0; i < size; i++)
+        list.push_head(P::make(i));
+    report->add(name, P::name(), "push_head", size, size,
+                timer.elapsed_ns());
+
+    int calls = scans(size);
+    int64_t sum = 0;
+    timer.reset();
+    for (int i = 0; i < calls; i++)
+        list.apply_reverse([&sum](const T& data) { sum += P::key(data); });
+    report->add(name, P::name(), "apply_reverse", size, calls,
+                timer.elapsed_ns());
+    do_not_optimize(sum);
+}
+
+template<typename T>
+void measure_payload(int size, Report* report) {
+    measure_list<OneWayList<T>, T>("OneWayList", size, report);
+    measure_list<TwoWayList<T>, T>("TwoWayList", size, report);
+    measure_two_way<T>(size, report);
+}
+
+int main(int argc, char* argv[]) {
+    int max_size = argc > 1 ? std::atoi(argv[1]) : 10000000;
+    Report report;
+    for (int64_t size = 10; size <= max_size; size *= 10) {
+        measure_payload<int>(static_cast<int>(size), &report);
+        measure_payload<Movable>(static_cast<int>(size), &report);
+        measure_payload<std::unique_ptr<int>>(static_cast<int>(size),
+                                              &report);
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <functional>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+// Measure find and erase_by_value of random data - ns per operation
+// every erased data is pushed again, so the list keeps its size
+template<typename L>
+void measure(const char* name, L& list, int count, int operations) {
+    for (int i = 0; i < count; i++)
+        list.push(i);
+    Random random;
+    int found = 0;
+    Timer timer;
+    for (int i = 0; i < operations; i++)
+        found += list.find(random(count));
+    int64_t find_ns = timer.elapsed_ns() / operations;
+    timer.reset();
+    for (int i = 0; i < operations; i++) {
+        int data = random(count);
+        list.erase_by_value(data);
+        list.push(data);
+    }
+    int64_t erase_ns = timer.elapsed_ns() / operations;
+    do_not_optimize(found);
+    std::cout << name << "\t" << count << "\t" << find_ns << "\t" <<
+                 erase_ns << std::endl;
+}
+
+int main() {
+    std::hash<int> hash;
+    std::cout << "lookup by value, ns per operation" << std::endl;
+    std::cout << "list\tsize\tfind\terase_by_value" << std::endl;
+    const int sizes[] = {1000, 100000, 1000000};
+    for (int count : sizes) {
+        // the scans take O(n), fewer operations on long lists
+        int operations = count >= 100000 ? 200 : count / 2;
+        {
+            OneWayList<int> list(is_equal);
+            measure("OneWayList", list, count, operations);
+        }
+        {
+            OneWayList<int> list(is_equal);
+            list.enable_value_index(hash);
+            measure("OneWayList indexed", list, count, operations);
+        }
+        {
+            TwoWayList<int> list(is_equal);
+            measure("TwoWayList", list, count, operations);
+        }
+        {
+            TwoWayList<int> list(is_equal);
+            list.enable_value_index(hash);
+            measure("TwoWayList indexed", list, count, operations);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Copyright 2020 for cpplint
+
+#include <iostream>
+#include <functional>
+#include "benchmarks/benchmark.h"
+#include "include/one_way_list.h"
+#include "include/two_way_list.h"
+
+bool is_equal(const int& data1, const int& data2) {
+    return data1 == data2;
+}
+
+void report(const char* name, int64_t items, int64_t elapsed) {
+    std::cout << name << "\t" << elapsed / 1000000.0 << "\t" <<
+                 static_cast<double>(elapsed) / items << std::endl;
+}
+
+// Compare the std::function and the template traversals of the lists
+// with count items, every traversal is repeated
+template<typename FunctionList, typename TemplateList>
+void compare(FunctionList& function_list, TemplateList& template_list,
+             int count, int repeat) {
+    for (int i = 0; i < count; i++) {
+        function_list.push(i % 100);
+        template_list.push(i % 100);
+    }
+    int64_t items = static_cast<int64_t>(count) * repeat;
+    int found = 0;
+    Timer timer;
+    for (int i = 0; i < repeat; i++)
+        found += function_list.find(7);
+    report("find, std::function", items, timer.elapsed_ns());
+    timer.reset();
+    for (int i = 0; i < repeat; i++)
+        found += template_list.find(7);
+    report("find, Equal type", items, timer.elapsed_ns());
+    do_not_optimize(found);
+
+    int64_t sum = 0;
+    std::function<void(const int&)> callback = [&sum](const int& data) {
+        sum += data;
+    };
+    timer.reset();
+    for (int i = 0; i < repeat; i++)
+        function_list.apply(callback);
+    report("apply, std::function", items, timer.elapsed_ns());
+    timer.reset();
+    for (int i = 0; i < repeat; i++)
+        template_list.apply([&sum](const int& data) { sum += data; });
+    report("apply, template", items, timer.elapsed_ns());
+    do_not_optimize(sum);
+}
+
+int main() {
+    std::cout << "operation\ttotal, ms\tper item, ns" << std::endl;
+    // the long lists show the cost of the memory, the short lists which
+    // stay in the cache show the cost of the calls
+    const int counts[] = {10000000, 10000};
+    const int repeats[] = {1, 1000};
+    for (int i = 0; i < 2; i++) {
+        std::cout << "OneWayList, " << counts[i] << " items" << std::endl;
+        OneWayList<int> one_function(is_equal);
+        OneWayList<int, HeapAllocator, std::equal_to<int>> one_template(
+                (std::equal_to<int>()));
+        compare(one_function, one_template, counts[i], repeats[i]);
+
+        std::cout << "TwoWayList, " << counts[i] << " items" << std::endl;
+        TwoWayList<int> two_function(is_equal);
+        TwoWayList<int, HeapAllocator, std::equal_to<int>> two_template(
+                (std::equal_to<int>()));
+        compare(two_function, two_template, counts[i], repeats[i]);
+    }
+    return 0;
+}
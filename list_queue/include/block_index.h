@@ -0,0 +1,350 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "include/thread_pool.h"
+
+// Index of the items of a linked list
+// the items are split into blocks of about kBlockSize items in list order,
+// the index keeps the first item of every block and a Fenwick tree over
+// the numbers of items in the blocks
+// we can
+// - find the item by index in O(log n + kBlockSize)
+// - register items added to the end or to the head in O(1) amortized
+// - register erased items, the first and the last one in O(1) amortized
+// - visit the items on all threads of a pool, runs of blocks are the tasks
+// Empty blocks are kept in front of the first one for the items added to
+// the head, the room is doubled when it runs out. The empty blocks left by
+// the erased items are dropped when they outnumber the others. Both rebuild
+// the tree from the counts of the blocks, the list is not walked.
+// Changes the index can not follow make it stale, it is rebuilt from the
+// list on the next lookup.
+template<typename Node>
+class BlockIndex {
+ public:
+    // the number of items in a new block
+    static const int kBlockSize = 32;
+    // the number of blocks in a task of a parallel visit
+    static const int kTaskBlocks = 64;
+    // the least number of empty blocks added in front of the first one
+    static const int kFrontBlocks = 16;
+
+ private:
+    // the first item of every block, nullptr for empty blocks
+    std::unique_ptr<Node*[]> starts_;
+    // the number of items in every block
+    std::unique_ptr<int[]> counts_;
+    // Fenwick tree over counts_, starts from 1
+    std::unique_ptr<int[]> tree_;
+    // the number of blocks
+    int blocks_;
+    // the number of allocated blocks
+    int capacity_;
+    // the number of empty blocks
+    int empty_blocks_;
+    // the first block which can be not empty
+    int first_;
+    // the index does not match the list
+    bool stale_;
+
+    // Allocate the arrays for the number of blocks
+    void reserve(int capacity) {
+        std::unique_ptr<Node*[]> starts(new Node*[capacity]);
+        std::unique_ptr<int[]> counts(new int[capacity]);
+        std::unique_ptr<int[]> tree(new int[capacity + 1]);
+        for (int i = 0; i < blocks_; i++) {
+            starts[i] = starts_[i];
+            counts[i] = counts_[i];
+            tree[i + 1] = tree_[i + 1];
+        }
+        starts_ = std::move(starts);
+        counts_ = std::move(counts);
+        tree_ = std::move(tree);
+        capacity_ = capacity;
+    }
+
+    // Build the tree from counts_ in O(blocks)
+    void build_tree() {
+        for (int i = 1; i <= blocks_; i++)
+            tree_[i] = counts_[i - 1];
+        for (int i = 1; i <= blocks_; i++) {
+            int parent = i + (i & -i);
+            if (parent <= blocks_)
+                tree_[parent] += tree_[i];
+        }
+    }
+
+    // The number of blocks with items
+    int live_blocks() const {
+        return blocks_ - empty_blocks_;
+    }
+
+    // The number of empty blocks in front kept for the items added to the
+    // head, up to the number of blocks with items
+    int front_room() const {
+        int most = live_blocks() + kFrontBlocks;
+        return first_ < most ? first_ : most;
+    }
+
+    // Add the empty blocks in front of the first one, as many as the
+    // blocks with items
+    void grow_front() {
+        int room = live_blocks() + kFrontBlocks;
+        int capacity = capacity_ + room;
+        std::unique_ptr<Node*[]> starts(new Node*[capacity]);
+        std::unique_ptr<int[]> counts(new int[capacity]);
+        for (int i = 0; i < room; i++) {
+            starts[i] = nullptr;
+            counts[i] = 0;
+        }
+        for (int i = 0; i < blocks_; i++) {
+            starts[room + i] = starts_[i];
+            counts[room + i] = counts_[i];
+        }
+        starts_ = std::move(starts);
+        counts_ = std::move(counts);
+        tree_.reset(new int[capacity + 1]);
+        capacity_ = capacity;
+        blocks_ += room;
+        empty_blocks_ += room;
+        first_ += room;
+        build_tree();
+    }
+
+    // Drop the empty blocks except the room in front
+    void compact() {
+        if (live_blocks() == 0) {
+            reset();
+            return;
+        }
+        int room = front_room();
+        int kept = room;
+        for (int i = first_; i < blocks_; i++) {
+            if (counts_[i] > 0) {
+                starts_[kept] = starts_[i];
+                counts_[kept++] = counts_[i];
+            }
+        }
+        for (int i = 0; i < room; i++) {
+            starts_[i] = nullptr;
+            counts_[i] = 0;
+        }
+        blocks_ = kept;
+        empty_blocks_ = room;
+        first_ = room;
+        build_tree();
+    }
+
+    // Change the number of items in the block
+    void add(int block, int delta) {
+        if (counts_[block] == 0)
+            empty_blocks_--;
+        counts_[block] += delta;
+        if (counts_[block] == 0)
+            empty_blocks_++;
+        for (int i = block + 1; i <= blocks_; i += i & -i)
+            tree_[i] += delta;
+    }
+
+    // Add the block to the end
+    void append(Node* start, int count) {
+        if (blocks_ == capacity_)
+            reserve(capacity_ * 2 + 16);
+        starts_[blocks_] = start;
+        counts_[blocks_] = count;
+        if (count == 0)
+            empty_blocks_++;
+        blocks_++;
+        // the tree item covers the new count and the tree items below it
+        int low = blocks_ - (blocks_ & -blocks_);
+        tree_[blocks_] = count;
+        for (int i = blocks_ - 1; i > low; i -= i & -i)
+            tree_[blocks_] += tree_[i];
+    }
+
+    // Split the list into the new blocks
+    void rebuild(Node* head) {
+        blocks_ = 0;
+        empty_blocks_ = 0;
+        first_ = 0;
+        stale_ = false;
+        while (head) {
+            Node* start = head;
+            int count = 0;
+            while (head && count < kBlockSize) {
+                head = head->next_.get();
+                count++;
+            }
+            append(start, count);
+        }
+    }
+
+    // Find the block holding the item by index
+    // - return the block and the position of the item in the block
+    int locate(int index, int* offset) const {
+        int block = 0;
+        int step = 1;
+        while (step * 2 <= blocks_)
+            step *= 2;
+        // the last block with fewer items before it than the index
+        for (; step > 0; step /= 2) {
+            if (block + step <= blocks_ && tree_[block + step] <= index) {
+                block += step;
+                index -= tree_[block];
+            }
+        }
+        *offset = index;
+        return block;
+    }
+
+    // Call the function for the items of the blocks of the task
+    template<typename F>
+    void visit(int task, F& callback) const {
+        int first = task * kTaskBlocks;
+        int last = first + kTaskBlocks;
+        if (last > blocks_)
+            last = blocks_;
+        // the items of the blocks follow each other in the list
+        int count = 0;
+        Node* node = nullptr;
+        for (int block = first; block < last; block++) {
+            if (!node)
+                node = starts_[block];
+            count += counts_[block];
+        }
+        for (; count > 0; count--, node = node->next_.get())
+            callback(node->data_);
+    }
+
+ public:
+    BlockIndex() : blocks_(0), capacity_(0), empty_blocks_(0), first_(0),
+                   stale_(true) {
+    }
+
+    // Make the index stale, it is rebuilt on the next lookup
+    void invalidate() {
+        stale_ = true;
+    }
+
+    // Forget all items
+    void reset() {
+        blocks_ = 0;
+        empty_blocks_ = 0;
+        first_ = 0;
+        stale_ = false;
+    }
+
+    // Find the item by index, the index must be less than the list size
+    // - return the item and the block of the item, and the number of items
+    //   walked over in the block if walked is not nullptr
+    Node* find(Node* head, int index, int* block, int* walked = nullptr) {
+        if (stale_)
+            rebuild(head);
+        int offset;
+        *block = locate(index, &offset);
+        if (walked)
+            *walked = offset;
+        Node* node = starts_[*block];
+        while (offset-- > 0)
+            node = node->next_.get();
+        return node;
+    }
+
+    // Count the items matching the predicate on all threads of the pool
+    // the index is rebuilt first if it is stale
+    template<typename Pred>
+    int64_t parallel_count(Node* head, ThreadPool& pool, Pred& pred) {
+        if (stale_)
+            rebuild(head);
+        int tasks = (blocks_ + kTaskBlocks - 1) / kTaskBlocks;
+        return pool.sum(tasks, [this, &pred](int task) {
+            int64_t count = 0;
+            auto check = [&pred, &count](const decltype(Node::data_)& data) {
+                if (pred(data))
+                    count++;
+            };
+            visit(task, check);
+            return count;
+        });
+    }
+
+    // Apply the function to all items on all threads of the pool
+    // the index is rebuilt first if it is stale
+    template<typename F>
+    void parallel_apply(Node* head, ThreadPool& pool, F& callback) {
+        if (stale_)
+            rebuild(head);
+        int tasks = (blocks_ + kTaskBlocks - 1) / kTaskBlocks;
+        pool.run(tasks, [this, &callback](int task) {
+            visit(task, callback);
+        });
+    }
+
+    // The item has been added to the end
+    void push_back(Node* node) {
+        if (stale_)
+            return;
+        if (blocks_ > 0 && counts_[blocks_ - 1] == 0) {
+            starts_[blocks_ - 1] = node;
+            add(blocks_ - 1, 1);
+        } else if (blocks_ > 0 && counts_[blocks_ - 1] < kBlockSize) {
+            add(blocks_ - 1, 1);
+        } else {
+            append(node, 1);
+        }
+    }
+
+    // The item has been added to the head
+    void push_front(Node* node) {
+        if (stale_)
+            return;
+        if (blocks_ == 0) {
+            append(node, 1);
+            return;
+        }
+        // the blocks before first_ are empty, a full block is preceded by
+        // a new one
+        if (counts_[first_] >= kBlockSize) {
+            if (first_ == 0)
+                grow_front();
+            first_--;
+        }
+        starts_[first_] = node;
+        add(first_, 1);
+    }
+
+    // The item of the block is about to be erased, next is the item after it
+    void erase(int block, Node* node, Node* next) {
+        if (stale_)
+            return;
+        add(block, -1);
+        if (starts_[block] == node)
+            starts_[block] = counts_[block] > 0 ? next : nullptr;
+        // drop the empty blocks when most blocks are empty, the queue use
+        // leaves them behind the head
+        if (empty_blocks_ - front_room() > live_blocks() + 2 * kFrontBlocks)
+            compact();
+    }
+
+    // The last item is about to be erased, it is not the first item
+    void erase_back(Node* node) {
+        if (stale_)
+            return;
+        int block = blocks_ - 1;
+        while (counts_[block] == 0)
+            block--;
+        erase(block, node, nullptr);
+    }
+
+    // The first item is about to be erased, next is the item after it
+    void erase_front(Node* node, Node* next) {
+        if (stale_)
+            return;
+        while (counts_[first_] == 0)
+            first_++;
+        erase(first_, node, next);
+    }
+};
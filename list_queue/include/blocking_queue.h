@@ -0,0 +1,222 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+#include "include/list.h"
+
+// Queue of items for producer and consumer threads
+// we can
+// - add item to the end, waiting while the queue is full
+// - add several items to the end
+// - get item from the head and move it from the queue, waiting while
+//   the queue is empty, with a timeout or without waiting
+// - get several items from the head
+// - close the queue, the waiting threads return
+// - get the number of items
+// Like Queue it decorates a list, every call locks a mutex. Only as many
+// waiting threads are woken as there are items or free places for them,
+// and they are woken after the mutex is released, so a woken thread does
+// not block on it again. The bulk calls wake the threads once per batch.
+template<typename T>
+class BlockingQueue {
+    List<T>& list_;
+    // the largest number of items, 0 for no limit
+    int capacity_;
+    std::mutex mutex_;
+    // consumers wait here for items
+    std::condition_variable not_empty_;
+    // producers wait here for free places
+    std::condition_variable not_full_;
+    // the number of waiting consumers and producers
+    int waiting_consumers_;
+    int waiting_producers_;
+    // no more items can be added
+    bool closed_;
+
+    bool is_full() {
+        return capacity_ > 0 && list_.size() >= capacity_;
+    }
+
+    // The number of free places
+    int room() {
+        return capacity_ > 0 ? capacity_ - list_.size() : 1 << 30;
+    }
+
+    // Wake up to count threads waiting on the variable
+    // waiting is the number of the waiting threads, read under the mutex
+    static void wake(std::condition_variable* variable, int count,
+                     int waiting) {
+        if (count >= waiting) {
+            if (waiting > 0)
+                variable->notify_all();
+            return;
+        }
+        while (count-- > 0)
+            variable->notify_one();
+    }
+
+    // Wait while the queue is empty and open
+    // - return false if the deadline has passed
+    template<typename Wait>
+    bool wait_for_items(std::unique_lock<std::mutex>& lock, Wait wait) {
+        while (list_.is_empty() && !closed_) {
+            waiting_consumers_++;
+            bool in_time = wait(lock);
+            waiting_consumers_--;
+            if (!in_time)
+                return !list_.is_empty();
+        }
+        return true;
+    }
+
+    // Take the first item out, the queue must not be empty
+    void take(std::unique_lock<std::mutex>& lock, T* data) {
+        move_to(data, list_.pop_front());
+        int waiting = waiting_producers_;
+        lock.unlock();
+        wake(&not_full_, 1, waiting);
+    }
+
+ public:
+    // Constructor
+    // capacity is the largest number of items, 0 for no limit
+    explicit BlockingQueue(List<T>& list, int capacity = 0) :
+            list_(list),
+            capacity_(capacity > 0 ? capacity : 0),
+            waiting_consumers_(0),
+            waiting_producers_(0),
+            closed_(false) {
+    }
+
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    // Add the data to the end, wait while the queue is full
+    // - return false if the queue is closed
+    bool push(T data) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (is_full() && !closed_) {
+            waiting_producers_++;
+            not_full_.wait(lock);
+            waiting_producers_--;
+        }
+        if (closed_)
+            return false;
+        list_.push(std::move(data));
+        int waiting = waiting_consumers_;
+        lock.unlock();
+        wake(&not_empty_, 1, waiting);
+        return true;
+    }
+
+    // Add count data from the array to the end, the data are moved out
+    // wait while the queue is full
+    // - return the number of added data, less than count if the queue
+    //   has been closed
+    int push_bulk(T* data, int count) {
+        int pushed = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (pushed < count) {
+            while (is_full() && !closed_) {
+                waiting_producers_++;
+                not_full_.wait(lock);
+                waiting_producers_--;
+            }
+            if (closed_)
+                break;
+            int batch = count - pushed < room() ? count - pushed : room();
+            list_.push_range(data + pushed, batch);
+            pushed += batch;
+            int waiting = waiting_consumers_;
+            lock.unlock();
+            wake(&not_empty_, batch, waiting);
+            lock.lock();
+        }
+        return pushed;
+    }
+
+    // Move the first item to the data, wait while the queue is empty
+    // - return false if the queue is closed and empty
+    bool pop(T* data) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait_for_items(lock, [this](std::unique_lock<std::mutex>& lock) {
+            not_empty_.wait(lock);
+            return true;
+        });
+        if (list_.is_empty())
+            return false;
+        take(lock, data);
+        return true;
+    }
+
+    // Move the first item to the data - return false if the queue is empty
+    bool try_pop(T* data) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (list_.is_empty())
+            return false;
+        take(lock, data);
+        return true;
+    }
+
+    // Move the first item to the data, wait up to the timeout while the
+    // queue is empty - return false if there is no item in time
+    template<typename Rep, typename Period>
+    bool pop_for(T* data, const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool found = wait_for_items(lock,
+                [this, &deadline](std::unique_lock<std::mutex>& lock) {
+            return not_empty_.wait_until(lock, deadline) ==
+                   std::cv_status::no_timeout;
+        });
+        if (!found || list_.is_empty())
+            return false;
+        take(lock, data);
+        return true;
+    }
+
+    // Move up to count first items to the array, wait while the queue
+    // is empty - return the number of moved items, 0 if the queue is
+    // closed and empty
+    int pop_bulk(T* data, int count) {
+        if (count <= 0)
+            return 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        wait_for_items(lock, [this](std::unique_lock<std::mutex>& lock) {
+            not_empty_.wait(lock);
+            return true;
+        });
+        int taken = list_.pop_range(data, count);
+        int waiting = waiting_producers_;
+        lock.unlock();
+        wake(&not_full_, taken, waiting);
+        return taken;
+    }
+
+    // Stop adding items, the waiting threads return
+    // the items in the queue can still be taken
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    bool is_closed() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    // The number of items
+    int size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return list_.size();
+    }
+};
@@ -0,0 +1,304 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+// Unique id of a concurrent queue
+// lets threads tell a new queue from a destroyed one at the same address
+inline uint64_t next_concurrent_queue_id() {
+    static std::atomic<uint64_t> id(0);
+    return ++id;
+}
+
+// Lock-free queue of items for many producers and many consumers
+// (the Michael-Scott queue, erased items are reclaimed with hazard pointers)
+// we can
+// - add item to the end
+// - get item from the head and move it from the queue
+// - check if the queue is empty
+template<typename T>
+class ConcurrentQueue {
+    // Item of the queue
+    // the first item is a dummy, its data has been moved out already
+    struct Node {
+        // next item
+        std::atomic<Node*> next_;
+        // data, constructed in all items but the dummy
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type data_;
+        // next erased item waiting for reclamation
+        Node* retired_next_;
+
+        Node() : next_(nullptr), retired_next_(nullptr) {
+        }
+
+        T* data() {
+            return reinterpret_cast<T*>(&data_);
+        }
+    };
+
+    // Hazard pointers of a thread
+    // a record is owned by one thread at a time and is never freed
+    // while the queue is alive
+    struct HazardRecord {
+        // items the thread is reading now
+        std::atomic<Node*> hazard_[2];
+        // is the record owned by a thread
+        std::atomic<bool> active_;
+        // next record
+        HazardRecord* next_;
+        // erased items waiting for reclamation
+        Node* retired_;
+        // the number of retired items
+        int retired_count_;
+
+        HazardRecord() : active_(true), next_(nullptr), retired_(nullptr),
+                         retired_count_(0) {
+            hazard_[0].store(nullptr);
+            hazard_[1].store(nullptr);
+        }
+    };
+
+    // Owns a hazard record for the scope
+    class HazardGuard {
+        ConcurrentQueue* queue_;
+        HazardRecord* record_;
+
+     public:
+        explicit HazardGuard(ConcurrentQueue* queue) :
+                queue_(queue),
+                record_(queue->acquire()) {
+        }
+
+        HazardGuard(const HazardGuard&) = delete;
+        HazardGuard& operator=(const HazardGuard&) = delete;
+
+        ~HazardGuard() {
+            queue_->release(record_);
+        }
+
+        HazardRecord* record() {
+            return record_;
+        }
+    };
+
+    // Record the thread used the last time
+    struct RecordCache {
+        uint64_t queue_id_;
+        HazardRecord* record_;
+    };
+
+    // the dummy item
+    alignas(64) std::atomic<Node*> head_;
+    // the last item or the one before it
+    alignas(64) std::atomic<Node*> tail_;
+    // hazard records of all threads
+    alignas(64) std::atomic<HazardRecord*> records_;
+    // the number of hazard records
+    std::atomic<int> record_count_;
+    // id of the queue
+    const uint64_t id_;
+
+    // Take the free record
+    static bool try_take(HazardRecord* record) {
+        bool active = false;
+        return !record->active_.load(std::memory_order_relaxed) &&
+               record->active_.compare_exchange_strong(active, true);
+    }
+
+    // Take a hazard record for the calling thread
+    HazardRecord* acquire() {
+        thread_local RecordCache cache = {0, nullptr};
+        // try the record the thread used the last time
+        if (cache.queue_id_ == id_ && try_take(cache.record_))
+            return cache.record_;
+        HazardRecord* record = records_.load();
+        while (record && !try_take(record))
+            record = record->next_;
+        if (!record) {
+            // all records are busy - add a new one
+            record = new HazardRecord();
+            HazardRecord* first = records_.load();
+            do {
+                record->next_ = first;
+            } while (!records_.compare_exchange_weak(first, record));
+            record_count_++;
+        }
+        cache.queue_id_ = id_;
+        cache.record_ = record;
+        return record;
+    }
+
+    // Give the hazard record back
+    void release(HazardRecord* record) {
+        record->hazard_[0].store(nullptr, std::memory_order_release);
+        record->hazard_[1].store(nullptr, std::memory_order_release);
+        record->active_.store(false, std::memory_order_release);
+    }
+
+    // Read the item from the pointer and protect it from reclamation
+    static Node* protect(HazardRecord* record, int index,
+                         const std::atomic<Node*>& pointer) {
+        Node* node = pointer.load();
+        while (true) {
+            record->hazard_[index].store(node);
+            Node* again = pointer.load();
+            if (again == node)
+                return node;
+            node = again;
+        }
+    }
+
+    // Is the item protected by any thread
+    bool is_hazard(Node* node) {
+        for (HazardRecord* record = records_.load(); record;
+             record = record->next_) {
+            if (record->hazard_[0].load() == node ||
+                record->hazard_[1].load() == node)
+                return true;
+        }
+        return false;
+    }
+
+    // Put the erased item aside and free the items nobody reads
+    void retire(HazardRecord* record, Node* node) {
+        node->retired_next_ = record->retired_;
+        record->retired_ = node;
+        record->retired_count_++;
+        if (record->retired_count_ < 4 * record_count_.load() + 16)
+            return;
+        Node* keep = nullptr;
+        int keep_count = 0;
+        Node* cur = record->retired_;
+        while (cur) {
+            Node* next = cur->retired_next_;
+            if (is_hazard(cur)) {
+                cur->retired_next_ = keep;
+                keep = cur;
+                keep_count++;
+            } else {
+                delete cur;
+            }
+            cur = next;
+        }
+        record->retired_ = keep;
+        record->retired_count_ = keep_count;
+    }
+
+    // Unlink the first item - return the item holding the data or nullptr
+    // the returned item stays protected by the record
+    Node* claim(HazardRecord* record) {
+        while (true) {
+            Node* head = protect(record, 0, head_);
+            Node* tail = tail_.load();
+            Node* next = head->next_.load();
+            record->hazard_[1].store(next);
+            if (head != head_.load())
+                continue;
+            if (!next)
+                return nullptr;
+            if (head == tail) {
+                // help the producer to move the tail
+                tail_.compare_exchange_strong(tail, next);
+                continue;
+            }
+            if (head_.compare_exchange_strong(head, next)) {
+                retire(record, head);
+                return next;
+            }
+        }
+    }
+
+ public:
+    // Constructor
+    ConcurrentQueue() :
+            head_(new Node()),
+            records_(nullptr),
+            record_count_(0),
+            id_(next_concurrent_queue_id()) {
+        tail_.store(head_.load());
+    }
+
+    ConcurrentQueue(const ConcurrentQueue&) = delete;
+    ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+    // No thread may use the queue while it is destroyed
+    ~ConcurrentQueue() {
+        Node* cur = head_.load();
+        Node* next = cur->next_.load();
+        delete cur;
+        for (cur = next; cur; cur = next) {
+            next = cur->next_.load();
+            cur->data()->~T();
+            delete cur;
+        }
+        HazardRecord* record = records_.load();
+        while (record) {
+            HazardRecord* next_record = record->next_;
+            Node* retired = record->retired_;
+            while (retired) {
+                Node* next_retired = retired->retired_next_;
+                delete retired;
+                retired = next_retired;
+            }
+            delete record;
+            record = next_record;
+        }
+    }
+
+    void enqueue(T data) {
+        std::unique_ptr<Node> node(new Node());
+        new(node->data()) T(std::move(data));
+        HazardGuard guard(this);
+        while (true) {
+            Node* tail = protect(guard.record(), 0, tail_);
+            Node* next = tail->next_.load();
+            if (tail != tail_.load())
+                continue;
+            if (next) {
+                // help the other producer to move the tail
+                tail_.compare_exchange_strong(tail, next);
+                continue;
+            }
+            if (tail->next_.compare_exchange_strong(next, node.get())) {
+                tail_.compare_exchange_strong(tail, node.get());
+                node.release();
+                return;
+            }
+        }
+    }
+
+    bool is_empty() {
+        HazardGuard guard(this);
+        Node* head = protect(guard.record(), 0, head_);
+        return head->next_.load() == nullptr;
+    }
+
+    T dequeue() {
+        HazardGuard guard(this);
+        Node* node = claim(guard.record());
+        if (!node)
+            throw std::runtime_error("Queue is empty");
+        T data(std::move(*node->data()));
+        node->data()->~T();
+        return data;
+    }
+
+    // Move the first item to the data - return false if the queue is empty
+    bool try_dequeue(T* data) {
+        HazardGuard guard(this);
+        Node* node = claim(guard.record());
+        if (!node)
+            return false;
+        *data = std::move(*node->data());
+        node->data()->~T();
+        return true;
+    }
+};
@@ -0,0 +1,71 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <utility>
+
+#include "include/two_way_list.h"
+
+// Double ended queue of items
+// we can
+// - get the number of items
+// - add item to the end or to the head, or build it there in place
+// - get the first or the last item
+// - get item from the head or from the end and move it from the queue
+// Like Queue it decorates a list, all operations take O(1).
+// ListImpl is the type of the list, TwoWayList or a list with the same
+// push_head, emplace_back, emplace_front, pop_back and get_last
+template<typename T, typename ListImpl = TwoWayList<T>>
+class Deque {
+    ListImpl& list_;
+
+ public:
+    // Constructor
+    explicit Deque(ListImpl& list) : list_(list) {
+    }
+
+    void push_back(T data) {
+        list_.push(std::move(data));
+    }
+
+    void push_front(T data) {
+        list_.push_head(std::move(data));
+    }
+
+    // Add the data built from the arguments in the new item at the end
+    template<typename... Args>
+    void emplace_back(Args&&... args) {
+        list_.emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Add the data built from the arguments in the new item at the head
+    template<typename... Args>
+    void emplace_front(Args&&... args) {
+        list_.emplace_front(std::forward<Args>(args)...);
+    }
+
+    bool is_empty() {
+        return list_.is_empty();
+    }
+
+    // The number of items
+    int size() const {
+        return list_.size();
+    }
+
+    T& front() {
+        return list_.get_first();
+    }
+
+    T& back() {
+        return list_.get_last();
+    }
+
+    T pop_front() {
+        return list_.pop_front();
+    }
+
+    T pop_back() {
+        return list_.pop_back();
+    }
+};
@@ -0,0 +1,350 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <stdexcept>
+
+// Links of an element of an intrusive one way list, a member of the element
+template<typename T>
+struct IntrusiveHook {
+    // next element
+    T* next_;
+    IntrusiveHook() : next_(nullptr) {
+    }
+};
+
+// Links of an element of an intrusive two way list, a member of the element
+template<typename T>
+struct IntrusiveHookBi {
+    // next element
+    T* next_;
+    // prev element
+    T* prev_;
+    IntrusiveHookBi() : next_(nullptr), prev_(nullptr) {
+    }
+};
+
+// List of elements linked by a hook inside them
+// the list does not own the elements and never allocates, the elements
+// must outlive the list or be erased first, an element can be in one list
+// per hook at a time
+// we can
+// - get the number of elements in O(1)
+// - get the first element
+// - take the first element out
+// - add element to the end
+// - move all elements of the other list to the end in O(1)
+// - erase element by address, O(1) for the first element and the element
+//   after the given one, O(n) for the others
+// - find the number of elements matching a predicate
+// - apply the specified function to the elements
+// - erase all elements
+// Hook is the member of T with the links, such as &Job::hook_
+template<typename T, IntrusiveHook<T> T::*Hook>
+class IntrusiveOneWayList {
+    // the first element
+    T* head_;
+    // the last element
+    T* tail_;
+    // the number of elements
+    int size_;
+
+    // The links of the element
+    static IntrusiveHook<T>& hook(T* item) {
+        return item->*Hook;
+    }
+
+ public:
+    IntrusiveOneWayList() : head_(nullptr), tail_(nullptr), size_(0) {
+    }
+
+    IntrusiveOneWayList(const IntrusiveOneWayList&) = delete;
+    IntrusiveOneWayList& operator=(const IntrusiveOneWayList&) = delete;
+
+    ~IntrusiveOneWayList() {
+        clear();
+    }
+
+    bool is_empty() const {
+        return !head_;
+    }
+
+    // The number of elements
+    int size() const {
+        return size_;
+    }
+
+    T& get_first() {
+        if (!head_)
+            throw std::runtime_error("List is empty");
+        return *head_;
+    }
+
+    // Take the first element out - return its address
+    T* pop_front() {
+        if (!head_)
+            throw std::runtime_error("List is empty");
+        T* item = head_;
+        head_ = hook(item).next_;
+        if (!head_)
+            tail_ = nullptr;
+        hook(item).next_ = nullptr;
+        size_--;
+        return item;
+    }
+
+    // Add the element to the end
+    void push(T* item) {
+        hook(item).next_ = nullptr;
+        if (head_)
+            hook(tail_).next_ = item;
+        else
+            head_ = item;
+        tail_ = item;
+        size_++;
+    }
+
+    // Move all elements of the other list to the end
+    void splice_back(IntrusiveOneWayList& other) {
+        if (&other == this || !other.head_)
+            return;
+        if (head_)
+            hook(tail_).next_ = other.head_;
+        else
+            head_ = other.head_;
+        tail_ = other.tail_;
+        size_ += other.size_;
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+    }
+
+    // Erase the element after prev, prev must be in the list
+    // - return the erased element, nullptr if prev is the last one
+    T* erase_after(T* prev) {
+        T* item = hook(prev).next_;
+        if (!item)
+            return nullptr;
+        hook(prev).next_ = hook(item).next_;
+        if (item == tail_)
+            tail_ = prev;
+        hook(item).next_ = nullptr;
+        size_--;
+        return item;
+    }
+
+    // Erase the element - return false if it is not in the list
+    bool erase(T* item) {
+        if (!head_)
+            return false;
+        if (item == head_) {
+            pop_front();
+            return true;
+        }
+        for (T* prev = head_; hook(prev).next_; prev = hook(prev).next_) {
+            if (hook(prev).next_ == item) {
+                erase_after(prev);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Find all elements matching the predicate - return their number
+    template<typename Pred>
+    int find_if(Pred&& pred) const {
+        int count = 0;
+        for (T* cur = head_; cur; cur = hook(cur).next_) {
+            if (pred(*cur))
+                count++;
+        }
+        return count;
+    }
+
+    // Apply the specified function to all elements
+    template<typename F>
+    void apply(F&& callback) {
+        for (T* cur = head_; cur; cur = hook(cur).next_)
+            callback(*cur);
+    }
+
+    // Erase all elements, their links are reset
+    void clear() {
+        while (head_) {
+            T* item = head_;
+            head_ = hook(item).next_;
+            hook(item).next_ = nullptr;
+        }
+        tail_ = nullptr;
+        size_ = 0;
+    }
+};
+
+// List of elements linked both ways by a hook inside them
+// the list does not own the elements and never allocates, the elements
+// must outlive the list or be erased first, an element can be in one list
+// per hook at a time
+// we can
+// - get the number of elements in O(1)
+// - get the first and the last element
+// - take the first or the last element out
+// - add element to the end or to the head
+// - move all elements of the other list to the end in O(1)
+// - erase element by address in O(1)
+// - find the number of elements matching a predicate
+// - apply the specified function to the elements in both directions
+// - erase all elements
+// Hook is the member of T with the links, such as &Job::hook_
+template<typename T, IntrusiveHookBi<T> T::*Hook>
+class IntrusiveTwoWayList {
+    // the first element
+    T* head_;
+    // the last element
+    T* last_;
+    // the number of elements
+    int size_;
+
+    // The links of the element
+    static IntrusiveHookBi<T>& hook(T* item) {
+        return item->*Hook;
+    }
+
+ public:
+    IntrusiveTwoWayList() : head_(nullptr), last_(nullptr), size_(0) {
+    }
+
+    IntrusiveTwoWayList(const IntrusiveTwoWayList&) = delete;
+    IntrusiveTwoWayList& operator=(const IntrusiveTwoWayList&) = delete;
+
+    ~IntrusiveTwoWayList() {
+        clear();
+    }
+
+    bool is_empty() const {
+        return !head_;
+    }
+
+    // The number of elements
+    int size() const {
+        return size_;
+    }
+
+    T& get_first() {
+        if (!head_)
+            throw std::runtime_error("List is empty");
+        return *head_;
+    }
+
+    T& get_last() {
+        if (!last_)
+            throw std::runtime_error("List is empty");
+        return *last_;
+    }
+
+    // Take the first element out - return its address
+    T* pop_front() {
+        if (!head_)
+            throw std::runtime_error("List is empty");
+        T* item = head_;
+        erase(item);
+        return item;
+    }
+
+    // Take the last element out - return its address
+    T* pop_back() {
+        if (!last_)
+            throw std::runtime_error("List is empty");
+        T* item = last_;
+        erase(item);
+        return item;
+    }
+
+    // Add the element to the end
+    void push(T* item) {
+        hook(item).next_ = nullptr;
+        hook(item).prev_ = last_;
+        if (last_)
+            hook(last_).next_ = item;
+        else
+            head_ = item;
+        last_ = item;
+        size_++;
+    }
+
+    // Add the element to the head
+    void push_head(T* item) {
+        hook(item).prev_ = nullptr;
+        hook(item).next_ = head_;
+        if (head_)
+            hook(head_).prev_ = item;
+        else
+            last_ = item;
+        head_ = item;
+        size_++;
+    }
+
+    // Move all elements of the other list to the end
+    void splice_back(IntrusiveTwoWayList& other) {
+        if (&other == this || !other.head_)
+            return;
+        hook(other.head_).prev_ = last_;
+        if (last_)
+            hook(last_).next_ = other.head_;
+        else
+            head_ = other.head_;
+        last_ = other.last_;
+        size_ += other.size_;
+        other.head_ = other.last_ = nullptr;
+        other.size_ = 0;
+    }
+
+    // Erase the element, it must be in the list
+    void erase(T* item) {
+        IntrusiveHookBi<T>& links = hook(item);
+        if (links.prev_)
+            hook(links.prev_).next_ = links.next_;
+        else
+            head_ = links.next_;
+        if (links.next_)
+            hook(links.next_).prev_ = links.prev_;
+        else
+            last_ = links.prev_;
+        links.next_ = links.prev_ = nullptr;
+        size_--;
+    }
+
+    // Find all elements matching the predicate - return their number
+    template<typename Pred>
+    int find_if(Pred&& pred) const {
+        int count = 0;
+        for (T* cur = head_; cur; cur = hook(cur).next_) {
+            if (pred(*cur))
+                count++;
+        }
+        return count;
+    }
+
+    // Apply the specified function to all elements
+    template<typename F>
+    void apply(F&& callback) {
+        for (T* cur = head_; cur; cur = hook(cur).next_)
+            callback(*cur);
+    }
+
+    // Apply the specified function to all elements from the last to the first
+    template<typename F>
+    void apply_reverse(F&& callback) {
+        for (T* cur = last_; cur; cur = hook(cur).prev_)
+            callback(*cur);
+    }
+
+    // Erase all elements, their links are reset
+    void clear() {
+        while (head_) {
+            T* item = head_;
+            head_ = hook(item).next_;
+            hook(item).next_ = hook(item).prev_ = nullptr;
+        }
+        last_ = nullptr;
+        size_ = 0;
+    }
+};
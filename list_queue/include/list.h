@@ -3,17 +3,42 @@
 #pragma once
 
 #include <memory>
+#include <new>
 #include <utility>
 #include <functional>
+#include <type_traits>
+
+// Move the value to the data
+// the data is destroyed and constructed again if T can not be assigned
+template<typename T>
+void move_to(T* data, T&& value, std::true_type /* assignable */) {
+    *data = std::move(value);
+}
+
+template<typename T>
+void move_to(T* data, T&& value, std::false_type /* assignable */) {
+    data->~T();
+    new(data) T(std::move(value));
+}
+
+template<typename T>
+void move_to(T* data, T&& value) {
+    move_to(data, std::move(value), std::is_move_assignable<T>());
+}
 
 // List of items
 // we can
+// - get the number of items
 // - get the first item
+// - take the first item out
+// - take several first items out
 // - add item to the end
+// - add several items to the end
 // - erase items by index
 // - erase items by value
 // - find the number of items by value
 // - apply the specified function to the items
+// - erase all items
 template<typename T>
 class List {
  public:
@@ -26,11 +51,32 @@ class List {
 
     virtual bool is_empty() = 0;
 
+    // The number of items
+    virtual int size() const = 0;
+
     virtual T& get_first() = 0;
 
+    // Move the data out of the first item and erase the item
+    virtual T pop_front() = 0;
+
     // Push data to the end
     virtual void push(T data) = 0;
 
+    // Push count data from the array to the end, the data are moved out
+    virtual void push_range(T* data, int count) {
+        for (int i = 0; i < count; i++)
+            push(std::move(data[i]));
+    }
+
+    // Move the data of up to count first items to the array and erase
+    // the items - return the number of moved data
+    virtual int pop_range(T* data, int count) {
+        int taken = 0;
+        while (taken < count && !is_empty())
+            move_to(data + taken++, pop_front());
+        return taken;
+    }
+
     // Erase item by index
     virtual void erase_by_index(int index) = 0;
 
@@ -43,68 +89,114 @@ class List {
     // Apply the specified function to all item
     virtual void apply(std::function<void(const T&)> callback) = 0;
 
+    // Erase all items
+    virtual void clear() = 0;
+
  protected:
     // function to compare two data
     std::function<bool(const T&, const T&)> is_equal_;
 
-    // Find all item with the specified data - return the number of such items
-    template<typename L>
-    int find(const T& data, const std::unique_ptr<L>& head) {
+    // Find all item matching the predicate - return the number of such items
+    template<typename L, typename D, typename Pred>
+    static int find_if(Pred& pred, const std::unique_ptr<L, D>& head) {
         int count = 0;
-        if (!head)
-            return count;
         // go through all items from the first
-        L* cur = head.get();
-        while (cur) {
-            if (is_equal_(cur->data_, data))
+        for (L* cur = head.get(); cur; cur = cur->next_.get()) {
+            if (pred(cur->data_))
                 count++;
-            cur = cur->next_.get();
         }
         return count;
     }
 
     // Apply the specified function to all item
-    template<typename L>
-    void apply(std::function<void(const T&)> callback,
-               const std::unique_ptr<L>& head) {
-        if (!head)
-            return;
+    template<typename L, typename D, typename F>
+    static void apply(F& callback, const std::unique_ptr<L, D>& head) {
         // go through all items from the first
-        L* cur = head.get();
-        while (cur) {
+        for (L* cur = head.get(); cur; cur = cur->next_.get())
             callback(cur->data_);
-            cur = cur->next_.get();
-        }
     }
+
+    // Erase all items one by one
+    // the items own the next item, so releasing the head would destroy
+    // the whole chain recursively and overflow the stack on long lists
+    template<typename L, typename D>
+    void clear(std::unique_ptr<L, D>* head) {
+        while (*head)
+            unlink(head);
+    }
+
+    // Destroy the item owned by the link and link the next item instead
+    // the next item is taken out first, the deleter of the link must not
+    // be read from the destroyed item
+    template<typename P>
+    static void unlink(P* link) {
+        P next = std::move((*link)->next_);
+        *link = std::move(next);
+    }
+};
+
+// Allocates items with new and delete
+struct HeapAllocator {
+    // releases an item
+    template<typename Node>
+    using Deleter = std::default_delete<Node>;
+
+    // Creates items
+    template<typename Node>
+    class Factory {
+     public:
+        template<typename... Args>
+        std::unique_ptr<Node> make(Args&&... args) {
+            return std::make_unique<Node>(std::forward<Args>(args)...);
+        }
+    };
 };
 
 // Item for one way list
-template<typename T>
+template<typename T, typename Alloc = HeapAllocator>
 struct ListItem {
+    // owning pointer to an item
+    using Pointer = std::unique_ptr<ListItem,
+                                    typename Alloc::template Deleter<ListItem>>;
     // next item
-    std::unique_ptr<ListItem> next_;
+    Pointer next_;
     // data
     T data_;
-    // Constructor
-    explicit ListItem(T data) :
+    // Constructor, the data is built in place from the arguments
+    template<typename... Args>
+    explicit ListItem(Args&&... args) :
             next_(nullptr),
-            data_(std::move(data)) {
+            data_(std::forward<Args>(args)...) {
     }
 };
 
 // Item for two way list
-template<typename T>
+template<typename T, typename Alloc = HeapAllocator>
 struct ListItemBi {
+    // owning pointer to an item
+    using Pointer = std::unique_ptr<
+            ListItemBi, typename Alloc::template Deleter<ListItemBi>>;
     // next item
-    std::unique_ptr<ListItemBi> next_;
+    Pointer next_;
     // data
     T data_;
     // prev item
     ListItemBi* prev_;
-    // Constructor
-    explicit ListItemBi(T data) :
+    // Constructor, the data is built in place from the arguments
+    template<typename... Args>
+    explicit ListItemBi(Args&&... args) :
         next_(nullptr),
-        data_(std::move(data)),
+        data_(std::forward<Args>(args)...),
         prev_(nullptr) {
     }
 };
+
+// Set the back link of the item, the items of one way lists have none
+template<typename T, typename Alloc>
+void set_prev(ListItem<T, Alloc>*, ListItem<T, Alloc>*) {
+}
+
+template<typename T, typename Alloc>
+void set_prev(ListItemBi<T, Alloc>* item, ListItemBi<T, Alloc>* prev) {
+    item->prev_ = prev;
+}
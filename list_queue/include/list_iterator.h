@@ -0,0 +1,146 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Forward iterator over the items of a list
+// V is T for iterator and const T for const_iterator
+template<typename Node, typename V>
+class ListIterator {
+    // current item, nullptr after the last item
+    Node* node_;
+
+ public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::remove_const<V>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = V*;
+    using reference = V&;
+
+    ListIterator() : node_(nullptr) {
+    }
+
+    explicit ListIterator(Node* node) : node_(node) {
+    }
+
+    // iterator converts to const_iterator
+    template<typename U, typename = typename std::enable_if<
+            std::is_same<const U, V>::value>::type>
+    ListIterator(const ListIterator<Node, U>& other)  // NOLINT
+            : node_(other.node()) {
+    }
+
+    Node* node() const {
+        return node_;
+    }
+
+    reference operator*() const {
+        return node_->data_;
+    }
+
+    pointer operator->() const {
+        return &node_->data_;
+    }
+
+    ListIterator& operator++() {
+        node_ = node_->next_.get();
+        return *this;
+    }
+
+    ListIterator operator++(int) {
+        ListIterator old = *this;
+        node_ = node_->next_.get();
+        return old;
+    }
+
+    template<typename U>
+    bool operator==(const ListIterator<Node, U>& other) const {
+        return node_ == other.node();
+    }
+
+    template<typename U>
+    bool operator!=(const ListIterator<Node, U>& other) const {
+        return node_ != other.node();
+    }
+};
+
+// Bidirectional iterator over the items of a two way list
+// V is T for iterator and const T for const_iterator
+template<typename Node, typename V>
+class ListIteratorBi {
+    // current item, nullptr after the last item
+    Node* node_;
+    // the last item pointer of the list, lets end() go back
+    Node* const* last_;
+
+ public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = typename std::remove_const<V>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = V*;
+    using reference = V&;
+
+    ListIteratorBi() : node_(nullptr), last_(nullptr) {
+    }
+
+    ListIteratorBi(Node* node, Node* const* last) : node_(node), last_(last) {
+    }
+
+    // iterator converts to const_iterator
+    template<typename U, typename = typename std::enable_if<
+            std::is_same<const U, V>::value>::type>
+    ListIteratorBi(const ListIteratorBi<Node, U>& other)  // NOLINT
+            : node_(other.node()), last_(other.last()) {
+    }
+
+    Node* node() const {
+        return node_;
+    }
+
+    Node* const* last() const {
+        return last_;
+    }
+
+    reference operator*() const {
+        return node_->data_;
+    }
+
+    pointer operator->() const {
+        return &node_->data_;
+    }
+
+    ListIteratorBi& operator++() {
+        node_ = node_->next_.get();
+        return *this;
+    }
+
+    ListIteratorBi operator++(int) {
+        ListIteratorBi old = *this;
+        node_ = node_->next_.get();
+        return old;
+    }
+
+    ListIteratorBi& operator--() {
+        node_ = node_ ? node_->prev_ : *last_;
+        return *this;
+    }
+
+    ListIteratorBi operator--(int) {
+        ListIteratorBi old = *this;
+        node_ = node_ ? node_->prev_ : *last_;
+        return old;
+    }
+
+    template<typename U>
+    bool operator==(const ListIteratorBi<Node, U>& other) const {
+        return node_ == other.node();
+    }
+
+    template<typename U>
+    bool operator!=(const ListIteratorBi<Node, U>& other) const {
+        return node_ != other.node();
+    }
+};
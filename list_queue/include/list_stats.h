@@ -0,0 +1,181 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Operations counted by the statistics of lists and queues
+enum class ListOp {
+    kPush,
+    kPushFront,
+    kPushRange,
+    kPopFront,
+    kPopBack,
+    kPopRange,
+    kFind,
+    kEraseByIndex,
+    kEraseByValue,
+    kApply,
+    kEnqueue,
+    kDequeue,
+};
+
+// The number of operations in ListOp
+const int kListOps = 12;
+
+// The name of the operation
+inline const char* op_name(ListOp op) {
+    static const char* const names[kListOps] = {
+        "push", "push_front", "push_range", "pop_front", "pop_back",
+        "pop_range", "find", "erase_by_index", "erase_by_value", "apply",
+        "enqueue", "dequeue"};
+    return names[static_cast<int>(op)];
+}
+
+// Statistics policy that records nothing
+// the calls are empty and are removed by the compiler
+struct NoStats {
+    static const bool kEnabled = false;
+
+    // Measures one call
+    // the empty destructor marks the probe as used, like the probe of
+    // ListStats, so the unused probes give no warnings
+    struct Probe {
+        ~Probe() {
+        }
+
+        void traversed(int64_t) {
+        }
+    };
+
+    Probe probe(ListOp) {
+        return Probe();
+    }
+
+    void length(int) {
+    }
+};
+
+// Statistics of one operation
+struct OpStats {
+    // the number of latency buckets, the last one takes all longer calls
+    static const int kBuckets = 40;
+
+    // the number of calls
+    int64_t calls;
+    // the number of items walked over by all calls
+    int64_t traversed;
+    // the largest number of items walked over by one call
+    int64_t max_traversed;
+    // latency[i] is the number of calls taking from 2^i to 2^(i+1) ns,
+    // latency[0] also counts the calls shorter than 1 ns
+    int64_t latency[kBuckets];
+
+    // The latency not exceeded by the share of calls, such as 0.99
+    // - return the upper bound of the bucket in ns, 0 without calls
+    int64_t latency_percentile(double share) const {
+        if (calls == 0)
+            return 0;
+        int64_t rank = static_cast<int64_t>(share * (calls - 1)) + 1;
+        int64_t seen = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            seen += latency[i];
+            if (seen >= rank)
+                return int64_t(2) << i;
+        }
+        return int64_t(2) << (kBuckets - 1);
+    }
+};
+
+// Statistics of a list or a queue at some moment
+struct StatsSnapshot {
+    OpStats ops[kListOps];
+    // the largest number of items
+    int peak_length;
+
+    const OpStats& operator[](ListOp op) const {
+        return ops[static_cast<int>(op)];
+    }
+};
+
+// Statistics policy that counts the calls, the items walked over by them,
+// the peak length and the latency of the calls
+// every call reads the clock twice, the statistics are not thread safe,
+// like the lists
+class ListStats {
+    StatsSnapshot data_;
+
+ public:
+    static const bool kEnabled = true;
+
+    // Measures one call, the call is recorded when the probe is destroyed
+    class Probe {
+        OpStats* op_;
+        std::chrono::steady_clock::time_point start_;
+        int64_t traversed_;
+
+     public:
+        explicit Probe(OpStats* op) :
+                op_(op),
+                start_(std::chrono::steady_clock::now()),
+                traversed_(0) {
+        }
+
+        // the moved out probe records nothing
+        Probe(Probe&& other) :
+                op_(other.op_),
+                start_(other.start_),
+                traversed_(other.traversed_) {
+            other.op_ = nullptr;
+        }
+
+        Probe(const Probe&) = delete;
+        Probe& operator=(const Probe&) = delete;
+
+        ~Probe() {
+            if (!op_)
+                return;
+            int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_).count();
+            int bucket = ns > 1 ? 63 - __builtin_clzll(ns) : 0;
+            if (bucket >= OpStats::kBuckets)
+                bucket = OpStats::kBuckets - 1;
+            op_->latency[bucket]++;
+            op_->calls++;
+            op_->traversed += traversed_;
+            if (traversed_ > op_->max_traversed)
+                op_->max_traversed = traversed_;
+        }
+
+        // Add the number of items walked over
+        void traversed(int64_t count) {
+            traversed_ += count;
+        }
+    };
+
+    ListStats() {
+        reset();
+    }
+
+    // Start measuring a call of the operation
+    Probe probe(ListOp op) {
+        return Probe(&data_.ops[static_cast<int>(op)]);
+    }
+
+    // Record the current number of items
+    void length(int size) {
+        if (size > data_.peak_length)
+            data_.peak_length = size;
+    }
+
+    // The copy of the statistics
+    StatsSnapshot snapshot() const {
+        return data_;
+    }
+
+    // Forget the recorded statistics
+    void reset() {
+        data_ = StatsSnapshot();
+    }
+};
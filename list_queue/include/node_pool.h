@@ -0,0 +1,170 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+// Pool of list items
+// we can
+// - create an item in a slot carved from a contiguous block
+// - destroy an item and keep its slot for the next item
+// - count the pooled and reused slots
+// The pool must outlive every list that takes items from it
+template<typename Node>
+class NodePool {
+    // free slot or storage for an item
+    union Slot {
+        Slot* next_;
+        typename std::aligned_storage<sizeof(Node), alignof(Node)>::type node_;
+    };
+
+    // block of slots
+    struct Block {
+        std::unique_ptr<Block> next_;
+        std::unique_ptr<Slot[]> slots_;
+    };
+
+    // the last allocated block
+    std::unique_ptr<Block> blocks_;
+    // the first free slot
+    Slot* free_;
+    // the first slot of the last block which has never been used
+    Slot* fresh_;
+    // the end of the last block
+    Slot* end_;
+    // the number of slots in a block
+    int block_size_;
+    // the number of slots carved from the blocks
+    int64_t pooled_;
+    // the number of slots taken from the free list
+    int64_t reused_;
+
+    // Take a slot from the free list or from the last block
+    Slot* take() {
+        if (free_) {
+            Slot* slot = free_;
+            free_ = slot->next_;
+            reused_++;
+            return slot;
+        }
+        if (fresh_ == end_) {
+            auto block = std::make_unique<Block>();
+            block->slots_.reset(new Slot[block_size_]);
+            block->next_ = std::move(blocks_);
+            blocks_ = std::move(block);
+            fresh_ = blocks_->slots_.get();
+            end_ = fresh_ + block_size_;
+        }
+        pooled_++;
+        return fresh_++;
+    }
+
+    // Put the slot to the free list
+    void give_back(Slot* slot) {
+        slot->next_ = free_;
+        free_ = slot;
+    }
+
+ public:
+    // Constructor
+    explicit NodePool(int block_size = 1024) :
+            free_(nullptr),
+            fresh_(nullptr),
+            end_(nullptr),
+            block_size_(block_size > 0 ? block_size : 1),
+            pooled_(0),
+            reused_(0) {
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        // release blocks one by one
+        while (blocks_)
+            blocks_ = std::move(blocks_->next_);
+    }
+
+    // Create an item in a free slot
+    template<typename... Args>
+    Node* create(Args&&... args) {
+        Slot* slot = take();
+        try {
+            return new(&slot->node_) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            give_back(slot);
+            throw;
+        }
+    }
+
+    // Destroy the item and keep its slot
+    void destroy(Node* node) {
+        node->~Node();
+        give_back(reinterpret_cast<Slot*>(node));
+    }
+
+    // The number of slots carved from the blocks
+    int64_t pooled() const {
+        return pooled_;
+    }
+
+    // The number of items created in recycled slots
+    int64_t reused() const {
+        return reused_;
+    }
+};
+
+// Returns items to their pool
+template<typename Node>
+class PoolDeleter {
+    NodePool<Node>* pool_;
+
+ public:
+    PoolDeleter() : pool_(nullptr) {
+    }
+
+    explicit PoolDeleter(NodePool<Node>* pool) : pool_(pool) {
+    }
+
+    void operator()(Node* node) const {
+        pool_->destroy(node);
+    }
+};
+
+// Allocates items from a NodePool
+// the list takes the pool in its constructor:
+//     NodePool<OneWayList<int, PoolAllocator>::Node> pool;
+//     OneWayList<int, PoolAllocator> list(is_equal, pool);
+struct PoolAllocator {
+    // returns an item to its pool
+    template<typename Node>
+    using Deleter = PoolDeleter<Node>;
+
+    // Creates items in the pool
+    template<typename Node>
+    class Factory {
+        NodePool<Node>* pool_;
+
+     public:
+        Factory() : pool_(nullptr) {
+        }
+
+        Factory(NodePool<Node>& pool) : pool_(&pool) {  // NOLINT
+        }
+
+        template<typename... Args>
+        std::unique_ptr<Node, Deleter<Node>> make(Args&&... args) {
+            if (!pool_)
+                throw std::runtime_error("Node pool is not set");
+            return std::unique_ptr<Node, Deleter<Node>>(
+                    pool_->create(std::forward<Args>(args)...),
+                    Deleter<Node>(pool_));
+        }
+    };
+};
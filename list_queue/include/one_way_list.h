@@ -6,125 +6,582 @@
 #include <utility>
 #include <functional>
 #include <exception>
+#include <stdexcept>
 
+#include "include/block_index.h"
 #include "include/list.h"
+#include "include/list_iterator.h"
+#include "include/list_stats.h"
+#include "include/value_index.h"
 
 // List of items
 // we can
+// - get the number of items in O(1)
 // - get the first item
+// - get item by index
+// - take the first item out
+// - take several first items out
 // - add item to the end
+// - add several items to the end
+// - build item in place at the end or at the head
+// - move all items of the other list to the end
+// - sort the items, merge the other sorted list, erase repeated items,
+//   the items are relinked and not allocated
 // - erase items by index
 // - erase items by value
 // - find the number of items by value
 // - apply the specified function to the items
-template<typename T>
+// - count and apply on all threads of a thread pool
+// - erase all items
+// - get the statistics of the calls
+// - iterate over the items with begin() and end()
+// With the block index enabled at and erase_by_index take O(log n) instead
+// of O(n), the index costs about 16 bytes per 32 items.
+// With the value index enabled find takes O(1) and erase_by_value stops
+// after the last matching item, the data must not be changed in place then.
+// Alloc is the item allocation policy - HeapAllocator or PoolAllocator
+// Equal is the type of the function to compare two data, a function object
+// type such as std::equal_to<T> lets the compiler inline the comparison
+// Stats is the statistics policy - NoStats or ListStats, ListStats counts
+// the calls, the items they walk over, the peak length and the latency
+// Item is the type of the items, TwoWayList derives from the list of items
+// with back links and shares the items and the indexes with it
+template<typename T, typename Alloc = HeapAllocator,
+         typename Equal = std::function<bool(const T&, const T&)>,
+         typename Stats = NoStats,
+         typename Item = ListItem<T, Alloc>>
 class OneWayList: public List<T> {
+ public:
+    // item of the list
+    using Node = Item;
+    // creates items
+    using Factory = typename Alloc::template Factory<Node>;
+    // forward iterators over the data
+    using iterator = ListIterator<Node, T>;
+    using const_iterator = ListIterator<Node, const T>;
+    // index of the items by data
+    using ValueIndexType = ValueIndex<T, Node, Equal>;
+
  protected:
+    // function to compare two data
+    Equal equal_;
+    // creates items
+    Factory factory_;
     // the first item
-    std::unique_ptr<ListItem<T>> head_;
+    typename Node::Pointer head_;
+    // the last item
+    Node* tail_;
+    // the number of items
+    int size_;
+    // index for access by index, nullptr if disabled
+    std::unique_ptr<BlockIndex<Node>> block_index_;
+    // index of the items by data, nullptr if disabled
+    std::unique_ptr<ValueIndexType> value_index_;
+    // statistics of the calls
+    Stats stats_;
+
+    // Add the chain of items from first to last to the end
+    void link_back(typename Node::Pointer first, Node* last) {
+        set_prev(first.get(), tail_);
+        if (head_)
+            tail_->next_ = std::move(first);
+        else
+            head_ = std::move(first);
+        tail_ = last;
+    }
+
+    // Erase the first item
+    void unlink_front() {
+        if (block_index_)
+            block_index_->erase_front(head_.get(), head_->next_.get());
+        if (value_index_)
+            value_index_->erase(head_.get());
+        List<T>::unlink(&head_);
+        if (head_)
+            set_prev(head_.get(), static_cast<Node*>(nullptr));
+        else
+            tail_ = nullptr;
+        size_--;
+    }
+
+    // Erase the item after prev
+    void unlink_after(Node* prev) {
+        if (prev->next_.get() == tail_)
+            tail_ = prev;
+        if (value_index_)
+            value_index_->erase(prev->next_.get());
+        List<T>::unlink(&prev->next_);
+        if (prev->next_)
+            set_prev(prev->next_.get(), prev);
+        size_--;
+    }
+
+    // Sorted chain of items
+    struct Run {
+        typename Node::Pointer head;
+        Node* tail = nullptr;
+    };
+
+    // Merge two sorted chains - return the merged chain
+    // on equal data the items of first go before the items of second,
+    // the back links are set on the way, the head has none
+    template<typename Compare>
+    static Run merge_runs(Run first, Run second, Compare& less) {
+        Run merged;
+        typename Node::Pointer* link = &merged.head;
+        Node* prev = nullptr;
+        while (first.head && second.head) {
+            Run& from = less(second.head->data_, first.head->data_) ?
+                        second : first;
+            // the link takes the item, the chain goes to the next one
+            *link = std::move(from.head);
+            from.head = std::move((*link)->next_);
+            set_prev(link->get(), prev);
+            prev = link->get();
+            link = &(*link)->next_;
+        }
+        Run& rest = first.head ? first : second;
+        if (rest.head) {
+            set_prev(rest.head.get(), prev);
+            merged.tail = rest.tail;
+        } else {
+            merged.tail = prev;
+        }
+        *link = std::move(rest.head);
+        return merged;
+    }
+
+    // Put the sorted chain into the list
+    void set_run(Run run) {
+        head_ = std::move(run.head);
+        tail_ = run.tail;
+        if (head_)
+            set_prev(head_.get(), static_cast<Node*>(nullptr));
+    }
+
+    // Rebuild the indexes after the items have been reordered
+    void reindex() {
+        if (block_index_)
+            block_index_->invalidate();
+        if (value_index_) {
+            value_index_->reset();
+            for (Node* cur = head_.get(); cur; cur = cur->next_.get())
+                value_index_->push_back(cur);
+        }
+    }
+
+    // Find the item by index, the index must be less than the size
+    // - return the item and the number of items walked over
+    Node* item_at(int index, int* walked) {
+        int block;
+        if (block_index_)
+            return block_index_->find(head_.get(), index, &block, walked);
+        *walked = index;
+        Node* cur = head_.get();
+        while (index-- > 0)
+            cur = cur->next_.get();
+        return cur;
+    }
 
  public:
     // Constructor
-    explicit OneWayList(std::function<bool(const T&, const T&)> is_equal) :
-            List<T>(is_equal) {
+    explicit OneWayList(Equal is_equal, Factory factory = Factory()) :
+            List<T>(is_equal),
+            equal_(is_equal),
+            factory_(factory),
+            tail_(nullptr),
+            size_(0) {
+    }
+
+    ~OneWayList() override {
+        List<T>::clear(&head_);
     }
 
     bool is_empty() override {
         return !head_;
     }
 
+    // The number of items
+    int size() const override {
+        return size_;
+    }
+
+    // The statistics of the calls, ListStats has snapshot()
+    const Stats& stats() const {
+        return stats_;
+    }
+
+    // Turn the block index on or off
+    // the index is built from the list on the first lookup
+    void enable_block_index(bool enable = true) {
+        if (!enable)
+            block_index_.reset();
+        else if (!block_index_)
+            block_index_ = std::make_unique<BlockIndex<Node>>();
+    }
+
+    // Turn the value index on with the function to hash data
+    // equal data must have equal hashes, the index is built from the list
+    void enable_value_index(typename ValueIndexType::Hash hash) {
+        value_index_ = std::make_unique<ValueIndexType>(hash, equal_);
+        for (Node* cur = head_.get(); cur; cur = cur->next_.get())
+            value_index_->push_back(cur);
+    }
+
+    // Turn the value index off
+    void disable_value_index() {
+        value_index_.reset();
+    }
+
+    // The data of the item by index
+    T& at(int index) {
+        if (index < 0 || index >= size_)
+            throw std::runtime_error("Index out of range");
+        int walked;
+        return item_at(index, &walked)->data_;
+    }
+
     T& get_first() override {
         if (!head_)
             throw std::runtime_error("List is empty");
         return head_->data_;
     }
 
+    // Move the data out of the first item and erase the item
+    T pop_front() override {
+        auto probe = stats_.probe(ListOp::kPopFront);
+        if (!head_)
+            throw std::runtime_error("List is empty");
+        T data(std::move(head_->data_));
+        unlink_front();
+        return data;
+    }
+
     // Push data to the end
     void push(T data) override {
+        emplace_back(std::move(data));
+    }
+
+    // Add the data built from the arguments to the end
+    // the data is built in the new item, it is not copied or moved
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        auto probe = stats_.probe(ListOp::kPush);
         if (!head_) {  // empty ?
-            head_ = std::make_unique<ListItem<T>>(std::move(data));
+            head_ = factory_.make(std::forward<Args>(args)...);
+            tail_ = head_.get();
         } else {
-            auto new_item = std::make_unique<ListItem<T>>(std::move(data));
             // add the new item after the last item
-            ListItem<T>* last = head_.get();
-            while (last) {
-                if (last->next_)
-                    last = last->next_.get();
-                else
-                    break;
+            tail_->next_ = factory_.make(std::forward<Args>(args)...);
+            set_prev(tail_->next_.get(), tail_);
+            tail_ = tail_->next_.get();
+        }
+        size_++;
+        if (block_index_)
+            block_index_->push_back(tail_);
+        if (value_index_)
+            value_index_->push_back(tail_);
+        stats_.length(size_);
+        return tail_->data_;
+    }
+
+    // Add the data built from the arguments to the head
+    // the data is built in the new item, it is not copied or moved
+    template<typename... Args>
+    T& emplace_front(Args&&... args) {
+        auto probe = stats_.probe(ListOp::kPushFront);
+        auto new_item = factory_.make(std::forward<Args>(args)...);
+        new_item->next_ = std::move(head_);
+        head_ = std::move(new_item);
+        if (head_->next_)
+            set_prev(head_->next_.get(), head_.get());
+        else
+            tail_ = head_.get();
+        size_++;
+        if (block_index_)
+            block_index_->push_front(head_.get());
+        if (value_index_)
+            value_index_->push_front(head_.get());
+        stats_.length(size_);
+        return head_->data_;
+    }
+
+    // Push count data from the array to the end, the data are moved out
+    // the items are linked together first and added with one link
+    void push_range(T* data, int count) override {
+        auto probe = stats_.probe(ListOp::kPushRange);
+        if (count <= 0)
+            return;
+        typename Node::Pointer first = factory_.make(std::move(data[0]));
+        Node* last = first.get();
+        try {
+            for (int i = 1; i < count; i++) {
+                last->next_ = factory_.make(std::move(data[i]));
+                set_prev(last->next_.get(), last);
+                last = last->next_.get();
             }
-            last->next_ = std::move(new_item);
+        } catch (...) {
+            List<T>::clear(&first);
+            throw;
+        }
+        if (block_index_) {
+            for (Node* cur = first.get(); cur; cur = cur->next_.get())
+                block_index_->push_back(cur);
+        }
+        if (value_index_) {
+            for (Node* cur = first.get(); cur; cur = cur->next_.get())
+                value_index_->push_back(cur);
+        }
+        link_back(std::move(first), last);
+        size_ += count;
+        stats_.length(size_);
+    }
+
+    // Move the data of up to count first items to the array and erase
+    // the items - return the number of moved data
+    int pop_range(T* data, int count) override {
+        auto probe = stats_.probe(ListOp::kPopRange);
+        int taken = 0;
+        while (taken < count && head_) {
+            move_to(data + taken++, std::move(head_->data_));
+            unlink_front();
+        }
+        return taken;
+    }
+
+    // Move all items of the other list to the end without copying
+    void splice_back(OneWayList& other) {
+        if (&other == this || !other.head_)
+            return;
+        if (value_index_) {
+            for (Node* cur = other.head_.get(); cur; cur = cur->next_.get())
+                value_index_->push_back(cur);
+        }
+        if (other.value_index_)
+            other.value_index_->reset();
+        Node* last = other.tail_;
+        other.tail_ = nullptr;
+        link_back(std::move(other.head_), last);
+        size_ += other.size_;
+        other.size_ = 0;
+        if (block_index_)
+            block_index_->invalidate();
+        if (other.block_index_)
+            other.block_index_->reset();
+    }
+
+    // Sort the items in O(n log n) with the bottom-up merge sort, equal
+    // items keep their order, less(a, b) is true if a goes before b
+    // the items are relinked, bins[i] holds a sorted run of 2^i items or
+    // nothing, each item is added like a carry to a binary counter
+    template<typename Compare = std::less<T>>
+    void sort(Compare less = Compare()) {
+        if (size_ < 2)
+            return;
+        Run bins[64];
+        int filled = 0;
+        while (head_) {
+            Run run;
+            run.head = std::move(head_);
+            head_ = std::move(run.head->next_);
+            run.tail = run.head.get();
+            int i = 0;
+            // the older run goes first to keep equal items in order
+            for (; i < filled && bins[i].head; i++)
+                run = merge_runs(std::move(bins[i]), std::move(run), less);
+            bins[i] = std::move(run);
+            if (i == filled)
+                filled++;
+        }
+        Run sorted;
+        for (int i = 0; i < filled; i++)
+            sorted = merge_runs(std::move(bins[i]), std::move(sorted), less);
+        set_run(std::move(sorted));
+        reindex();
+    }
+
+    // Move the items of the other sorted list to this sorted list in
+    // O(n + m), the list stays sorted, on equal data the items of this
+    // list go first, the items are relinked
+    template<typename Compare = std::less<T>>
+    void merge(OneWayList&& other, Compare less = Compare()) {
+        if (&other == this || !other.head_)
+            return;
+        Run first;
+        first.head = std::move(head_);
+        first.tail = tail_;
+        Run second;
+        second.head = std::move(other.head_);
+        second.tail = other.tail_;
+        set_run(merge_runs(std::move(first), std::move(second), less));
+        size_ += other.size_;
+        other.tail_ = nullptr;
+        other.size_ = 0;
+        other.reindex();
+        reindex();
+    }
+
+    // Erase the items equal to the item before them
+    // - return the number of erased items
+    int unique() {
+        int old_size = size_;
+        Node* cur = head_.get();
+        while (cur && cur->next_) {
+            if (equal_(cur->data_, cur->next_->data_))
+                unlink_after(cur);
+            else
+                cur = cur->next_.get();
         }
+        if (block_index_ && size_ != old_size)
+            block_index_->invalidate();
+        return old_size - size_;
     }
 
     // Erase item by index
     void erase_by_index(int index) override {
-        int pos = 0;
-        if (!head_)
+        auto probe = stats_.probe(ListOp::kEraseByIndex);
+        if (index < 0 || index >= size_)
             return;
-        // go through all items from the first
-        ListItem<T>* prev = nullptr;
-        ListItem<T>* cur = head_.get();
-        while (cur) {
-            if (pos == index) {
-                if (pos == 0) {
-                    head_ = std::move(cur->next_);
-                } else {
-                    if (cur->next_) {
-                        prev->next_ = std::move(cur->next_);
-                    } else {
-                        prev->next_ = nullptr;
-                    }
-                }
-                break;
-            }
-            pos++;
-            prev = cur;
-            cur = cur->next_.get();
+        if (index == 0) {
+            unlink_front();
+            return;
+        }
+        int walked;
+        Node* prev = item_at(index - 1, &walked);
+        probe.traversed(walked);
+        if (block_index_) {
+            // the item can start the next block
+            int block;
+            Node* cur = block_index_->find(head_.get(), index, &block);
+            block_index_->erase(block, cur, cur->next_.get());
         }
+        unlink_after(prev);
     }
 
     // Erase all item with the specified data
     void erase_by_value(const T& data) override {
-        if (!head_)
+        auto probe = stats_.probe(ListOp::kEraseByValue);
+        // the number of matching items left, the value index knows it
+        int left = value_index_ ? value_index_->count(data) : size_;
+        if (left == 0)
             return;
-        ListItem<T>* prev = nullptr;
-        ListItem<T>* cur = head_.get();
+        int old_size = size_;
+        int visited = 0;
         // process head
-        while (cur) {
-            if (List<T>::is_equal_(cur->data_, data)) {
-                head_ = std::move(cur->next_);
-                cur = head_.get();
-            } else {
-                prev = cur;
-                cur = cur->next_.get();
-                break;
-            }
+        while (head_ && left > 0 && equal_(head_->data_, data)) {
+            unlink_front();
+            left--;
+            visited++;
         }
         // process all other items
-        while (cur) {
-            if (List<T>::is_equal_(cur->data_, data)) {
-                if (cur->next_) {
-                    prev->next_ = std::move(cur->next_);
-                    cur = prev->next_.get();
-                } else {
-                    prev->next_ = nullptr;
-                    cur = nullptr;
-                }
+        Node* prev = head_.get();
+        while (left > 0 && prev && prev->next_) {
+            visited++;
+            if (equal_(prev->next_->data_, data)) {
+                unlink_after(prev);
+                left--;
             } else {
-                prev = cur;
-                cur = cur->next_.get();
+                prev = prev->next_.get();
             }
         }
+        probe.traversed(visited);
+        if (block_index_ && size_ != old_size)
+            block_index_->invalidate();
     }
 
     // Find all item with the specified data - return the number of such items
     int find(const T& data) override {
-        return List<T>::template find<ListItem<T>>(data, head_);
+        auto probe = stats_.probe(ListOp::kFind);
+        if (value_index_)
+            return value_index_->count(data);
+        probe.traversed(size_);
+        return find_if([this, &data](const T& item) {
+            return equal_(item, data);
+        });
+    }
+
+    // Find all item matching the predicate - return the number of such items
+    template<typename Pred>
+    int find_if(Pred&& pred) {
+        return List<T>::find_if(pred, head_);
+    }
+
+    // Find all item with the specified data on all threads of the pool
+    // - return the number of such items, it does not depend on the threads
+    int parallel_count(ThreadPool& pool, const T& data) {
+        if (value_index_)
+            return value_index_->count(data);
+        return parallel_count_if(pool, [this, &data](const T& item) {
+            return equal_(item, data);
+        });
+    }
+
+    // Find all item matching the predicate on all threads of the pool
+    // - return the number of such items
+    // the runs of blocks of the block index are the tasks, without the
+    // index enabled a temporary one is built first
+    template<typename Pred>
+    int parallel_count_if(ThreadPool& pool, Pred&& pred) {
+        BlockIndex<Node> temporary;
+        BlockIndex<Node>& index = block_index_ ? *block_index_ : temporary;
+        return static_cast<int>(index.parallel_count(head_.get(), pool, pred));
+    }
+
+    // Apply the specified function to all item on all threads of the pool
+    // the function is called from several threads at once
+    template<typename F>
+    void parallel_apply(ThreadPool& pool, F&& callback) {
+        BlockIndex<Node> temporary;
+        BlockIndex<Node>& index = block_index_ ? *block_index_ : temporary;
+        index.parallel_apply(head_.get(), pool, callback);
     }
 
     // Apply the specified function to all item
     void apply(std::function<void(const T&)> callback) override {
-        List<T>::template apply<ListItem<T>>(callback, head_);
+        apply<std::function<void(const T&)>&>(callback);
+    }
+
+    // Apply the specified function to all item
+    // the function is called directly and can be inlined
+    template<typename F>
+    void apply(F&& callback) {
+        auto probe = stats_.probe(ListOp::kApply);
+        probe.traversed(size_);
+        List<T>::apply(callback, head_);
+    }
+
+    // Erase all items
+    void clear() override {
+        List<T>::clear(&head_);
+        tail_ = nullptr;
+        size_ = 0;
+        if (block_index_)
+            block_index_->reset();
+        if (value_index_)
+            value_index_->reset();
+    }
+
+    iterator begin() {
+        return iterator(head_.get());
+    }
+
+    iterator end() {
+        return iterator();
+    }
+
+    const_iterator begin() const {
+        return const_iterator(head_.get());
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
     }
 };
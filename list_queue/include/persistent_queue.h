@@ -0,0 +1,399 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// File mapped to memory for reading and writing
+class MappedFile {
+    int fd_;
+    char* data_;
+    size_t size_;
+
+    static std::runtime_error error(const std::string& path) {
+        return std::runtime_error(path + ": " + std::strerror(errno));
+    }
+
+ public:
+    MappedFile() : fd_(-1), data_(nullptr), size_(0) {
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    // Map the file, a missing file is created with the size filled with
+    // zeros, an existing file is mapped with its own size
+    // - return false if the file is missing and create is false
+    bool open(const std::string& path, size_t size, bool create) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR | (create ? O_CREAT : 0), 0644);
+        if (fd_ < 0) {
+            if (errno == ENOENT && !create)
+                return false;
+            throw error(path);
+        }
+        struct stat info;
+        if (fstat(fd_, &info) != 0)
+            throw error(path);
+        if (info.st_size == 0) {
+            if (ftruncate(fd_, static_cast<off_t>(size)) != 0)
+                throw error(path);
+        } else {
+            size = static_cast<size_t>(info.st_size);
+        }
+        void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          fd_, 0);
+        if (data == MAP_FAILED)
+            throw error(path);
+        data_ = static_cast<char*>(data);
+        size_ = size;
+        return true;
+    }
+
+    // Take the exclusive lock of the file, it is released when the file is
+    // closed or the process ends - return false if the lock is taken
+    bool lock() {
+        return flock(fd_, LOCK_EX | LOCK_NB) == 0;
+    }
+
+    // Unmap and close the file
+    void close() {
+        if (data_)
+            munmap(data_, size_);
+        if (fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    // Write the changed pages to the disk
+    void sync() {
+        if (data_)
+            msync(data_, size_, MS_SYNC);
+    }
+
+    char* data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+};
+
+// Queue of items kept in files, the items outlive the process
+// we can
+// - get the number of items
+// - add item to the end
+// - add several items to the end
+// - get item from the head in place without copying
+// - get item from the head and move it from the queue
+// - get several items from the head and move them from the queue
+// - write the changes to the disk
+// The items are kept in segment files of a directory, the files are mapped
+// to memory and the items are copied there directly. A segment holds a
+// fixed number of items, a full segment is followed by a new one, a read
+// segment is deleted. Each segment counts its items and the read position
+// is kept in a cursor file, both are updated after the items, so if the
+// process is killed the queue loses no added or taken item. After a
+// system crash the changes before the last sync are kept.
+// Opening reads the headers of the segments only, the items are not read.
+// One queue can use the directory at a time, the others fail to open it.
+// T must be trivially copyable, the items are stored as their bytes
+template<typename T>
+class PersistentQueue {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "PersistentQueue needs trivially copyable items");
+    static_assert(alignof(T) <= 64, "the items are aligned to 64 bytes");
+
+    // start of a segment file
+    struct SegmentHeader {
+        uint32_t magic;
+        // sizeof(T)
+        uint32_t item_size;
+        // the number of items the segment can hold
+        uint32_t capacity;
+        // the number of added items, set after the items are written
+        uint32_t count;
+    };
+
+    // the cursor file
+    struct CursorHeader {
+        uint32_t magic;
+        uint32_t reserved;
+        // segment number in the high half, item index in the low half,
+        // one store moves the cursor
+        uint64_t position;
+    };
+
+    static const uint32_t kSegmentMagic = 0x47455351;  // "QSEG"
+    static const uint32_t kCursorMagic = 0x52555351;   // "QSUR"
+    // offset of the items in a segment file
+    static const size_t kItemsOffset = 64;
+
+    // The mapped segment
+    struct Segment {
+        MappedFile file;
+        SegmentHeader* header;
+        uint32_t number;
+
+        T* items() {
+            return reinterpret_cast<T*>(file.data() + kItemsOffset);
+        }
+    };
+
+    std::string directory_;
+    // the number of items in a new segment
+    uint32_t capacity_;
+    MappedFile cursor_file_;
+    CursorHeader* cursor_;
+    // the segment to read from and its next item
+    Segment read_;
+    uint32_t read_index_;
+    // the segment to add to, the file is mapped twice when it is also
+    // the read segment
+    Segment write_;
+    // the number of items
+    int64_t size_;
+
+    std::string segment_path(uint32_t number) const {
+        char name[32];
+        snprintf(name, sizeof(name), "/segment-%010u.dat", number);
+        return directory_ + name;
+    }
+
+    // Map the segment, a new segment is created empty
+    // - return false if the segment is missing and create is false
+    bool map_segment(Segment* segment, uint32_t number, bool create) {
+        std::string path = segment_path(number);
+        size_t size = kItemsOffset +
+                      static_cast<size_t>(capacity_) * sizeof(T);
+        if (!segment->file.open(path, size, create))
+            return false;
+        if (segment->file.size() < kItemsOffset + sizeof(T))
+            throw std::runtime_error(path + ": not a segment of this queue");
+        segment->number = number;
+        segment->header = reinterpret_cast<SegmentHeader*>(
+                segment->file.data());
+        SegmentHeader* header = segment->header;
+        if (header->magic == 0) {
+            // a new file, the magic is set last
+            header->item_size = sizeof(T);
+            header->capacity = static_cast<uint32_t>(
+                    (segment->file.size() - kItemsOffset) / sizeof(T));
+            header->count = 0;
+            header->magic = kSegmentMagic;
+        }
+        size_t items = (segment->file.size() - kItemsOffset) / sizeof(T);
+        if (header->magic != kSegmentMagic ||
+                header->item_size != sizeof(T) || header->capacity > items)
+            throw std::runtime_error(path + ": not a segment of this queue");
+        return true;
+    }
+
+    // The number of items in the segment file, 0 if it is missing
+    uint32_t segment_count(uint32_t number) const {
+        int fd = ::open(segment_path(number).c_str(), O_RDONLY);
+        if (fd < 0)
+            return 0;
+        SegmentHeader header = SegmentHeader();
+        ssize_t read = pread(fd, &header, sizeof(header), 0);
+        ::close(fd);
+        return read == sizeof(header) ? header.count : 0;
+    }
+
+    bool segment_exists(uint32_t number) const {
+        return access(segment_path(number).c_str(), F_OK) == 0;
+    }
+
+    // Store the read position in the cursor file
+    // the release store keeps it after the reads of the items
+    void store_cursor() {
+        __atomic_store_n(&cursor_->position,
+                         static_cast<uint64_t>(read_.number) << 32 |
+                         read_index_, __ATOMIC_RELEASE);
+    }
+
+    // Store the number of items of the write segment
+    // the release store keeps it after the writes of the items
+    void store_count(uint32_t count) {
+        __atomic_store_n(&write_.header->count, count, __ATOMIC_RELEASE);
+    }
+
+    // Go to the next segment when the read segment is read to the end
+    // and there are items after it
+    void skip_read_segment() {
+        if (read_index_ < read_.header->capacity ||
+                read_.number == write_.number)
+            return;
+        uint32_t old_number = read_.number;
+        if (!map_segment(&read_, old_number + 1, false))
+            throw std::runtime_error(segment_path(old_number + 1) +
+                                     ": the segment is missing");
+        read_index_ = 0;
+        store_cursor();
+        // the cursor has moved, a crash before unlink leaves the file
+        // for the next open to delete
+        unlink(segment_path(old_number).c_str());
+    }
+
+    // Start the next segment when the write segment is full
+    // the full segment is written to the disk before it is unmapped,
+    // so sync has to write the current segment only
+    void rotate_write_segment() {
+        if (write_.header->count < write_.header->capacity)
+            return;
+        write_.file.sync();
+        map_segment(&write_, write_.number + 1, true);
+    }
+
+ public:
+    // Constructor
+    // directory keeps the files of the queue, it is created if missing,
+    // an existing queue is opened, segment_items is the number of items in
+    // a new segment
+    explicit PersistentQueue(const std::string& directory,
+                             int segment_items = 1 << 16) :
+            directory_(directory),
+            capacity_(segment_items > 0 ? segment_items : 1),
+            size_(0) {
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+            throw std::runtime_error(directory + ": " + std::strerror(errno));
+        std::string path = directory + "/cursor.dat";
+        cursor_file_.open(path, sizeof(CursorHeader), true);
+        if (!cursor_file_.lock())
+            throw std::runtime_error(path + ": the queue is open already");
+        cursor_ = reinterpret_cast<CursorHeader*>(cursor_file_.data());
+        if (cursor_->magic == 0) {
+            cursor_->position = 0;
+            cursor_->magic = kCursorMagic;
+        }
+        if (cursor_->magic != kCursorMagic)
+            throw std::runtime_error(path + ": not a queue cursor");
+        uint32_t number = static_cast<uint32_t>(cursor_->position >> 32);
+        read_index_ = static_cast<uint32_t>(cursor_->position);
+        // the previous segment is left if the process ended before unlink
+        if (number > 0)
+            unlink(segment_path(number - 1).c_str());
+        map_segment(&read_, number, true);
+        // the segments after the read one are counted by their headers
+        size_ = static_cast<int64_t>(read_.header->count) - read_index_;
+        while (segment_exists(number + 1))
+            size_ += segment_count(++number);
+        map_segment(&write_, number, false);
+    }
+
+    PersistentQueue(const PersistentQueue&) = delete;
+    PersistentQueue& operator=(const PersistentQueue&) = delete;
+
+    bool is_empty() const {
+        return size_ == 0;
+    }
+
+    // The number of items
+    int64_t size() const {
+        return size_;
+    }
+
+    // Copy the data to the end of the queue
+    void enqueue(const T& data) {
+        rotate_write_segment();
+        SegmentHeader* header = write_.header;
+        std::memcpy(write_.items() + header->count, &data, sizeof(T));
+        store_count(header->count + 1);
+        size_++;
+    }
+
+    // Copy count data from the array to the end of the queue
+    // the data are copied with one call per segment
+    void enqueue_bulk(const T* data, int count) {
+        while (count > 0) {
+            rotate_write_segment();
+            SegmentHeader* header = write_.header;
+            uint32_t room = header->capacity - header->count;
+            uint32_t batch = static_cast<uint32_t>(count) < room ?
+                             static_cast<uint32_t>(count) : room;
+            std::memcpy(write_.items() + header->count, data,
+                        batch * sizeof(T));
+            store_count(header->count + batch);
+            size_ += batch;
+            data += batch;
+            count -= batch;
+        }
+    }
+
+    // The first item in the file, it is valid until it is taken out
+    const T& get_first() {
+        if (size_ == 0)
+            throw std::runtime_error("Queue is empty");
+        skip_read_segment();
+        return read_.items()[read_index_];
+    }
+
+    // Take the first item out without copying it, after get_first
+    void consume() {
+        if (size_ == 0)
+            throw std::runtime_error("Queue is empty");
+        skip_read_segment();
+        read_index_++;
+        store_cursor();
+        size_--;
+    }
+
+    // Copy the first item and take it out
+    T dequeue() {
+        T data = get_first();
+        consume();
+        return data;
+    }
+
+    // Copy up to count first items to the array and take them out
+    // - return the number of items
+    int dequeue_bulk(T* data, int count) {
+        int taken = 0;
+        while (taken < count && size_ > 0) {
+            skip_read_segment();
+            uint32_t end = read_.number == write_.number ?
+                           write_.header->count : read_.header->capacity;
+            uint32_t batch = end - read_index_;
+            if (batch > static_cast<uint32_t>(count - taken))
+                batch = static_cast<uint32_t>(count - taken);
+            std::memcpy(data + taken, read_.items() + read_index_,
+                        batch * sizeof(T));
+            read_index_ += batch;
+            store_cursor();
+            size_ -= batch;
+            taken += static_cast<int>(batch);
+        }
+        return taken;
+    }
+
+    // Write the added items and the read position to the disk
+    void sync() {
+        write_.file.sync();
+        cursor_file_.sync();
+        int fd = ::open(directory_.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+    }
+};
@@ -0,0 +1,152 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "include/list.h"
+
+// Queue of items ordered by priority
+// we can
+// - get the number of items
+// - add item in O(log n)
+// - add several items
+// - get the item with the highest priority
+// - get the item with the highest priority and move it from the queue
+//   in O(log n)
+// The items are kept in a binary heap in an array, the array grows twice
+// when it is full.
+// Compare(a, b) is true if a has lower priority than b, with std::less
+// the largest item comes first. Items with equal priority come in any
+// order.
+template<typename T, typename Compare = std::less<T>>
+class PriorityQueue {
+    // storage for an item
+    using Slot = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    // function to compare two items
+    Compare less_;
+    // the heap, count_ items from the start are constructed
+    std::unique_ptr<Slot[]> slots_;
+    // the number of items
+    int count_;
+    // the number of slots
+    int capacity_;
+
+    T* items() {
+        return reinterpret_cast<T*>(slots_.get());
+    }
+
+    // Move the items to the new array twice as large
+    void grow() {
+        int capacity = capacity_ > 0 ? capacity_ * 2 : 16;
+        std::unique_ptr<Slot[]> slots(new Slot[capacity]);
+        T* from = items();
+        T* to = reinterpret_cast<T*>(slots.get());
+        for (int i = 0; i < count_; i++) {
+            new(to + i) T(std::move(from[i]));
+            from[i].~T();
+        }
+        slots_ = std::move(slots);
+        capacity_ = capacity;
+    }
+
+    // Move the item at pos up while it has higher priority than its parent
+    void sift_up(int pos) {
+        T* heap = items();
+        T data(std::move(heap[pos]));
+        while (pos > 0) {
+            int parent = (pos - 1) / 2;
+            if (!less_(heap[parent], data))
+                break;
+            move_to(heap + pos, std::move(heap[parent]));
+            pos = parent;
+        }
+        move_to(heap + pos, std::move(data));
+    }
+
+    // Move the data down from pos while a child has higher priority
+    void sift_down(int pos, T data) {
+        T* heap = items();
+        while (true) {
+            int child = 2 * pos + 1;
+            if (child >= count_)
+                break;
+            if (child + 1 < count_ && less_(heap[child], heap[child + 1]))
+                child++;
+            if (!less_(data, heap[child]))
+                break;
+            move_to(heap + pos, std::move(heap[child]));
+            pos = child;
+        }
+        move_to(heap + pos, std::move(data));
+    }
+
+ public:
+    // Constructor
+    explicit PriorityQueue(Compare less = Compare()) :
+            less_(less),
+            count_(0),
+            capacity_(0) {
+    }
+
+    PriorityQueue(const PriorityQueue&) = delete;
+    PriorityQueue& operator=(const PriorityQueue&) = delete;
+
+    ~PriorityQueue() {
+        T* heap = items();
+        for (int i = 0; i < count_; i++)
+            heap[i].~T();
+    }
+
+    bool is_empty() const {
+        return count_ == 0;
+    }
+
+    // The number of items
+    int size() const {
+        return count_;
+    }
+
+    void enqueue(T data) {
+        if (count_ == capacity_)
+            grow();
+        new(items() + count_) T(std::move(data));
+        sift_up(count_++);
+    }
+
+    // Enqueue count data from the array, the data are moved out
+    void enqueue_bulk(T* data, int count) {
+        for (int i = 0; i < count; i++)
+            enqueue(std::move(data[i]));
+    }
+
+    // The item with the highest priority
+    const T& get_first() {
+        if (count_ == 0)
+            throw std::runtime_error("Queue is empty");
+        return items()[0];
+    }
+
+    // Move the item with the highest priority out of the queue
+    T dequeue() {
+        if (count_ == 0)
+            throw std::runtime_error("Queue is empty");
+        T* heap = items();
+        T data(std::move(heap[0]));
+        count_--;
+        if (count_ > 0) {
+            T last(std::move(heap[count_]));
+            heap[count_].~T();
+            sift_down(0, std::move(last));
+        } else {
+            heap[0].~T();
+        }
+        return data;
+    }
+};
@@ -6,31 +6,81 @@
 #include <utility>
 #include <functional>
 
+#include "include/list_stats.h"
 #include "include/one_way_list.h"
 
 // Queue of items
 // we can
-// - add item to the end
+// - get the number of items
+// - add item to the end, or build it from the arguments
+// - add several items to the end
 // - get item from the head and move it from the queue
-template<typename T>
+// - get several items from the head and move them from the queue
+// - get the statistics of the calls
+// Stats is the statistics policy - NoStats or ListStats, ListStats counts
+// the calls, the peak length and the latency
+template<typename T, typename Stats = NoStats>
 class Queue {
     List<T>& list_;
+    // statistics of the calls
+    Stats stats_;
+
+    // Record the length, the size is not read without the statistics
+    void record_length() {
+        if (Stats::kEnabled)
+            stats_.length(list_.size());
+    }
+
  public:
     // Constructor
     explicit Queue(List<T>& list) : list_(list) {
     }
 
     void enqueue(T data) {
+        auto probe = stats_.probe(ListOp::kEnqueue);
         list_.push(std::move(data));
+        record_length();
+    }
+
+    // Enqueue the data built from the arguments
+    // the list is reached through List<T>, so the data is built once and
+    // moved into the item, StaticQueue builds it in the item
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        auto probe = stats_.probe(ListOp::kEnqueue);
+        list_.push(T(std::forward<Args>(args)...));
+        record_length();
+    }
+
+    // Enqueue count data from the array, the data are moved out
+    void enqueue_bulk(T* data, int count) {
+        auto probe = stats_.probe(ListOp::kPushRange);
+        list_.push_range(data, count);
+        record_length();
     }
 
     bool is_empty() {
         return list_.is_empty();
     }
 
+    // The number of items
+    int size() const {
+        return list_.size();
+    }
+
     T dequeue() {
-        T data = std::move(list_.get_first());
-        list_.erase_by_index(0);
-        return data;
+        auto probe = stats_.probe(ListOp::kDequeue);
+        return list_.pop_front();
+    }
+
+    // Dequeue up to count items to the array - return the number of items
+    int dequeue_bulk(T* data, int count) {
+        auto probe = stats_.probe(ListOp::kPopRange);
+        return list_.pop_range(data, count);
+    }
+
+    // The statistics of the calls, ListStats has snapshot()
+    const Stats& stats() const {
+        return stats_;
     }
 };
@@ -0,0 +1,295 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+#include "include/list.h"
+
+// What push does when the ring buffer is full
+enum class FullPolicy {
+    // wait until the consumer takes an item
+    kBlock,
+    // throw from push, return false from try_push
+    kFail,
+    // erase the first item
+    kOverwrite
+};
+
+// Ring buffer of items with the fixed capacity
+// for one producer thread and one consumer thread
+// we can
+// - get the number of items
+// - get the first item
+// - take the first item out
+// - add item to the end (producer)
+// - erase items by index
+// - erase items by value
+// - find the number of items by value
+// - apply the specified function to the items
+// - erase all items
+// The producer calls push and try_push, everything else is called by the
+// consumer. push is wait-free with kFail, with kOverwrite it waits only
+// while the consumer is moving the first item out. The consumer is
+// wait-free. With kOverwrite the producer may erase the first item at any
+// moment, so the consumer may only use is_empty, size, pop_front, try_pop,
+// erase_by_index(0) and clear while the producer is running.
+template<typename T>
+class RingBuffer : public List<T> {
+    // Slot of the ring
+    // seq_ is the ticket the slot waits for: the producer writes item
+    // number seq_ when seq_ is its ticket, the slot holds item number
+    // seq_ - 1 when seq_ is the consumer's ticket plus one
+    struct Slot {
+        std::atomic<size_t> seq_;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type data_;
+
+        T* data() {
+            return reinterpret_cast<T*>(&data_);
+        }
+    };
+
+    // slots of the ring
+    std::unique_ptr<Slot[]> slots_;
+    // the number of slots, a power of two
+    size_t capacity_;
+    // capacity - 1
+    size_t mask_;
+    // what push does when the ring is full
+    FullPolicy policy_;
+    // the ticket of the first item - written by the consumer
+    alignas(64) std::atomic<size_t> head_;
+    // the ticket of the next pushed item - written by the producer
+    alignas(64) std::atomic<size_t> tail_;
+
+    static size_t round_capacity(size_t capacity) {
+        size_t rounded = 1;
+        while (rounded < capacity)
+            rounded <<= 1;
+        return rounded;
+    }
+
+    Slot& slot(size_t ticket) {
+        return slots_[ticket & mask_];
+    }
+
+    // Producer: write the data to the slot of the next ticket
+    // - return false if the ring is full and the policy is kFail
+    bool put(T* data) {
+        size_t ticket = tail_.load(std::memory_order_relaxed);
+        Slot& cur = slot(ticket);
+        while (cur.seq_.load(std::memory_order_acquire) != ticket) {
+            // the slot still holds the item ticket - capacity
+            if (policy_ == FullPolicy::kFail)
+                return false;
+            if (policy_ == FullPolicy::kOverwrite) {
+                size_t oldest = ticket - capacity_;
+                if (head_.compare_exchange_strong(oldest, oldest + 1)) {
+                    // the consumer has not claimed the item - erase it
+                    cur.data()->~T();
+                    break;
+                }
+            }
+            // the consumer is moving the item out
+            std::this_thread::yield();
+        }
+        new(cur.data()) T(std::move(*data));
+        cur.seq_.store(ticket + 1, std::memory_order_release);
+        tail_.store(ticket + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: claim the first item - return false if the ring is empty
+    bool claim(size_t* ticket) {
+        size_t first = head_.load(std::memory_order_acquire);
+        while (true) {
+            size_t seq = slot(first).seq_.load(std::memory_order_acquire);
+            if (seq != first + 1) {
+                if (seq == first)
+                    return false;
+                // the producer has erased the item
+                first = head_.load(std::memory_order_acquire);
+                continue;
+            }
+            if (policy_ != FullPolicy::kOverwrite)
+                break;
+            if (head_.compare_exchange_weak(first, first + 1))
+                break;
+        }
+        *ticket = first;
+        return true;
+    }
+
+    // Consumer: give the slot of the claimed item back to the producer
+    void release(size_t ticket) {
+        slot(ticket).seq_.store(ticket + capacity_, std::memory_order_release);
+        if (policy_ != FullPolicy::kOverwrite)
+            head_.store(ticket + 1, std::memory_order_release);
+    }
+
+    // Consumer: erase the first item - return false if the ring is empty
+    bool drop_first() {
+        size_t ticket;
+        if (!claim(&ticket))
+            return false;
+        slot(ticket).data()->~T();
+        release(ticket);
+        return true;
+    }
+
+    // Replace the item in the slot with the other item
+    void move_item(size_t to, size_t from) {
+        slot(to).data()->~T();
+        new(slot(to).data()) T(std::move(*slot(from).data()));
+    }
+
+ public:
+    // Constructor
+    // the capacity is rounded up to a power of two
+    RingBuffer(std::function<bool(const T&, const T&)> is_equal,
+               size_t capacity,
+               FullPolicy policy = FullPolicy::kBlock) :
+            List<T>(is_equal),
+            capacity_(round_capacity(capacity)),
+            mask_(capacity_ - 1),
+            policy_(policy),
+            head_(0),
+            tail_(0) {
+        slots_.reset(new Slot[capacity_]);
+        for (size_t i = 0; i < capacity_; i++)
+            slots_[i].seq_.store(i, std::memory_order_relaxed);
+    }
+
+    ~RingBuffer() override {
+        clear();
+    }
+
+    // The number of slots
+    size_t capacity() const {
+        return capacity_;
+    }
+
+    // The number of items
+    int size() const override {
+        return static_cast<int>(tail_.load(std::memory_order_acquire) -
+                                head_.load(std::memory_order_acquire));
+    }
+
+    bool is_empty() override {
+        return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire);
+    }
+
+    T& get_first() override {
+        size_t first = head_.load(std::memory_order_acquire);
+        if (slot(first).seq_.load(std::memory_order_acquire) != first + 1)
+            throw std::runtime_error("List is empty");
+        return *slot(first).data();
+    }
+
+    // Move the data out of the first item and erase the item
+    T pop_front() override {
+        size_t ticket;
+        if (!claim(&ticket))
+            throw std::runtime_error("List is empty");
+        T data(std::move(*slot(ticket).data()));
+        slot(ticket).data()->~T();
+        release(ticket);
+        return data;
+    }
+
+    // Push data to the end
+    // throws if the ring is full and the policy is kFail
+    void push(T data) override {
+        if (!put(&data))
+            throw std::runtime_error("Ring buffer is full");
+    }
+
+    // Push data to the end - return false if the ring is full and the policy
+    // is kFail
+    bool try_push(T data) {
+        return put(&data);
+    }
+
+    // Move the first item to the data - return false if the ring is empty
+    bool try_pop(T* data) {
+        size_t ticket;
+        if (!claim(&ticket))
+            return false;
+        *data = std::move(*slot(ticket).data());
+        slot(ticket).data()->~T();
+        release(ticket);
+        return true;
+    }
+
+    // Erase item by index
+    void erase_by_index(int index) override {
+        if (index < 0)
+            return;
+        if (index == 0) {
+            drop_first();
+            return;
+        }
+        size_t first = head_.load(std::memory_order_acquire);
+        size_t last = tail_.load(std::memory_order_acquire);
+        if (static_cast<size_t>(index) >= last - first)
+            return;
+        // move the items before the index one slot forward
+        for (size_t ticket = first + index; ticket != first; ticket--)
+            move_item(ticket, ticket - 1);
+        drop_first();
+    }
+
+    // Erase all item with the specified data
+    void erase_by_value(const T& data) override {
+        size_t first = head_.load(std::memory_order_acquire);
+        size_t last = tail_.load(std::memory_order_acquire);
+        // pack the other items to the end
+        size_t write = last;
+        for (size_t read = last; read != first; read--) {
+            if (List<T>::is_equal_(*slot(read - 1).data(), data))
+                continue;
+            write--;
+            if (write != read - 1)
+                move_item(write, read - 1);
+        }
+        // erase the freed items from the head
+        for (size_t ticket = first; ticket != write; ticket++)
+            drop_first();
+    }
+
+    // Find all item with the specified data - return the number of such items
+    int find(const T& data) override {
+        int count = 0;
+        size_t last = tail_.load(std::memory_order_acquire);
+        for (size_t ticket = head_.load(std::memory_order_acquire);
+             ticket != last; ticket++) {
+            if (List<T>::is_equal_(*slot(ticket).data(), data))
+                count++;
+        }
+        return count;
+    }
+
+    // Apply the specified function to all item
+    void apply(std::function<void(const T&)> callback) override {
+        size_t last = tail_.load(std::memory_order_acquire);
+        for (size_t ticket = head_.load(std::memory_order_acquire);
+             ticket != last; ticket++)
+            callback(*slot(ticket).data());
+    }
+
+    // Erase all items
+    void clear() override {
+        while (drop_first()) {
+        }
+    }
+};
@@ -0,0 +1,269 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Count data equal to the value in an array with SIMD instructions
+// AVX2 is used when the compiler targets it (-mavx2 or LIST_QUEUE_AVX2
+// in CMake), SSE2 otherwise on x86, a plain loop on other processors
+
+// Can the data be compared with SIMD instructions - T is an integer or
+// a floating point type and Equal compares with operator==
+template<typename T, typename Equal>
+struct is_simd_comparable : std::integral_constant<bool,
+        std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+        (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+         sizeof(T) == 8) &&
+        (std::is_same<Equal, std::equal_to<T>>::value ||
+         std::is_same<Equal, std::equal_to<>>::value)> {
+};
+
+namespace simd {
+
+// Count data equal to the value one by one
+template<typename T>
+int count_equal_scalar(const T* data, int count, T value) {
+    int found = 0;
+    for (int i = 0; i < count; i++)
+        found += data[i] == value;
+    return found;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+// Unsigned lane of the given size
+template<int Size> struct Lane;
+template<> struct Lane<1> { typedef uint8_t type; };
+template<> struct Lane<2> { typedef uint16_t type; };
+template<> struct Lane<4> { typedef uint32_t type; };
+template<> struct Lane<8> { typedef uint64_t type; };
+
+#if defined(__AVX2__)
+using Vector = __m256i;
+
+inline Vector zero() {
+    return _mm256_setzero_si256();
+}
+
+inline Vector load(const void* data) {
+    return _mm256_loadu_si256(static_cast<const Vector*>(data));
+}
+
+// Set all lanes of the given size to the bits of the value
+inline Vector broadcast(const void* value, Lane<1>) {
+    return _mm256_set1_epi8(*static_cast<const char*>(value));
+}
+
+inline Vector broadcast(const void* value, Lane<2>) {
+    int16_t lane;
+    std::memcpy(&lane, value, sizeof(lane));
+    return _mm256_set1_epi16(lane);
+}
+
+inline Vector broadcast(const void* value, Lane<4>) {
+    int32_t lane;
+    std::memcpy(&lane, value, sizeof(lane));
+    return _mm256_set1_epi32(lane);
+}
+
+inline Vector broadcast(const void* value, Lane<8>) {
+    int64_t lane;
+    std::memcpy(&lane, value, sizeof(lane));
+    return _mm256_set1_epi64x(lane);
+}
+
+// Compare the lanes - equal lanes are all ones
+inline Vector equal_lanes(const void* data, Vector value, Lane<1>) {
+    return _mm256_cmpeq_epi8(load(data), value);
+}
+
+inline Vector equal_lanes(const void* data, Vector value, Lane<2>) {
+    return _mm256_cmpeq_epi16(load(data), value);
+}
+
+inline Vector equal_lanes(const void* data, Vector value, Lane<4>) {
+    return _mm256_cmpeq_epi32(load(data), value);
+}
+
+inline Vector equal_lanes(const void* data, Vector value, Lane<8>) {
+    return _mm256_cmpeq_epi64(load(data), value);
+}
+
+inline Vector equal_lanes(const float* data, Vector value) {
+    return _mm256_castps_si256(_mm256_cmp_ps(
+            _mm256_loadu_ps(data), _mm256_castsi256_ps(value), _CMP_EQ_OQ));
+}
+
+inline Vector equal_lanes(const double* data, Vector value) {
+    return _mm256_castpd_si256(_mm256_cmp_pd(
+            _mm256_loadu_pd(data), _mm256_castsi256_pd(value), _CMP_EQ_OQ));
+}
+
+// Subtract the lanes
+inline Vector subtract(Vector a, Vector b, Lane<1>) {
+    return _mm256_sub_epi8(a, b);
+}
+
+inline Vector subtract(Vector a, Vector b, Lane<2>) {
+    return _mm256_sub_epi16(a, b);
+}
+
+inline Vector subtract(Vector a, Vector b, Lane<4>) {
+    return _mm256_sub_epi32(a, b);
+}
+
+inline Vector subtract(Vector a, Vector b, Lane<8>) {
+    return _mm256_sub_epi64(a, b);
+}
+#else
+using Vector = __m128i;
+
+inline Vector zero() {
+    return _mm_setzero_si128();
+}
+
+inline Vector load(const void* data) {
+    return _mm_loadu_si128(static_cast<const Vector*>(data));
+}
+
+// Set all lanes of the given size to the bits of the value
+inline Vector broadcast(const void* value, Lane<1>) {
+    return _mm_set1_epi8(*static_cast<const char*>(value));
+}
+
+inline Vector broadcast(const void* value, Lane<2>) {
+    int16_t lane;
+    std::memcpy(&lane, value, sizeof(lane));
+    return _mm_set1_epi16(lane);
+}
+
+inline Vector broadcast(const void* value, Lane<4>) {
+    int32_t lane;
+    std::memcpy(&lane, value, sizeof(lane));
+    return _mm_set1_epi32(lane);
+}
+
+inline Vector broadcast(const void* value, Lane<8>) {
+    int64_t lane;
+    std::memcpy(&lane, value, sizeof(lane));
+    return _mm_set1_epi64x(lane);
+}
+
+// Compare the lanes - equal lanes are all ones
+inline Vector equal_lanes(const void* data, Vector value, Lane<1>) {
+    return _mm_cmpeq_epi8(load(data), value);
+}
+
+inline Vector equal_lanes(const void* data, Vector value, Lane<2>) {
+    return _mm_cmpeq_epi16(load(data), value);
+}
+
+inline Vector equal_lanes(const void* data, Vector value, Lane<4>) {
+    return _mm_cmpeq_epi32(load(data), value);
+}
+
+// SSE2 has no 64 bit compare - both halves of the lane must be equal
+inline Vector equal_lanes(const void* data, Vector value, Lane<8>) {
+    Vector halves = _mm_cmpeq_epi32(load(data), value);
+    return _mm_and_si128(halves, _mm_shuffle_epi32(halves, 0xB1));
+}
+
+inline Vector equal_lanes(const float* data, Vector value) {
+    return _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(data),
+                                         _mm_castsi128_ps(value)));
+}
+
+inline Vector equal_lanes(const double* data, Vector value) {
+    return _mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(data),
+                                         _mm_castsi128_pd(value)));
+}
+
+// Subtract the lanes
+inline Vector subtract(Vector a, Vector b, Lane<1>) {
+    return _mm_sub_epi8(a, b);
+}
+
+inline Vector subtract(Vector a, Vector b, Lane<2>) {
+    return _mm_sub_epi16(a, b);
+}
+
+inline Vector subtract(Vector a, Vector b, Lane<4>) {
+    return _mm_sub_epi32(a, b);
+}
+
+inline Vector subtract(Vector a, Vector b, Lane<8>) {
+    return _mm_sub_epi64(a, b);
+}
+#endif
+
+// Integers are equal when their bits are equal
+template<typename T>
+Vector equal_lanes(const T* data, Vector value) {
+    return equal_lanes(static_cast<const void*>(data), value,
+                       Lane<sizeof(T)>());
+}
+
+// Add the lanes up
+template<int Size>
+int sum(Vector counts) {
+    const int kLanes = sizeof(Vector) / Size;
+    typename Lane<Size>::type lanes[kLanes];
+    std::memcpy(lanes, &counts, sizeof(counts));
+    int total = 0;
+    for (int i = 0; i < kLanes; i++)
+        total += static_cast<int>(lanes[i]);
+    return total;
+}
+
+// Count the data a vector at a time, the rest one by one
+// every lane counts its matches, the counts are added up before
+// a lane can overflow
+// floating point data are compared as numbers, 0.0 equals -0.0 and NaN
+// equals nothing
+template<typename T>
+int count_equal(const T* data, int count, T value) {
+    typedef Lane<sizeof(T)> L;
+    const int kLanes = sizeof(Vector) / sizeof(T);
+    const int kRun = sizeof(T) == 1 ? UINT8_MAX :
+                     (sizeof(T) == 2 ? UINT16_MAX : INT_MAX);
+    Vector target = broadcast(&value, L());
+    int found = 0;
+    int i = 0;
+    while (i + kLanes <= count) {
+        Vector counts = zero();
+        for (int run = 0; run < kRun && i + kLanes <= count;
+             run++, i += kLanes)
+            counts = subtract(counts, equal_lanes(data + i, target), L());
+        found += sum<sizeof(T)>(counts);
+    }
+    return found + count_equal_scalar(data + i, count - i, value);
+}
+
+#else
+
+template<typename T>
+int count_equal(const T* data, int count, T value) {
+    return count_equal_scalar(data, count, value);
+}
+
+#endif
+
+}  // namespace simd
+
+// Count the data equal to the value in the array of count data
+// T must be an arithmetic type
+template<typename T>
+int count_equal(const T* data, int count, T value) {
+    static_assert(is_simd_comparable<T, std::equal_to<T>>::value,
+                  "count_equal needs an arithmetic type");
+    return simd::count_equal(data, count, value);
+}
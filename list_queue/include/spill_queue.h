@@ -0,0 +1,255 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "include/list.h"
+
+// The number of the next SpillQueue of the process, it makes the names of
+// the page files unique
+inline int next_spill_queue() {
+    static std::atomic<int> queues(0);
+    return queues++;
+}
+
+// Queue of items that keeps the middle of a long queue on the disk
+// we can
+// - get the number of items
+// - add item to the end
+// - add several items to the end
+// - get item from the head and move it from the queue
+// - get the number of pages on the disk
+// Like Queue it decorates a list, the list keeps the head of the queue in
+// memory. When the queue grows past the memory budget the new items are
+// collected in a page in memory and each full page is written to its own
+// file. When the list has room for a page the first file is read back, the
+// next file is read by another thread while the list is consumed, so the
+// consumer does not wait for the disk. Adding and taking items stay O(1),
+// the memory holds about memory_items items of the list and two pages.
+// T must be trivially copyable, the pages are the bytes of the items
+template<typename T>
+class SpillQueue {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpillQueue needs trivially copyable items");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "the pages are aligned to std::max_align_t");
+
+    // items of a page
+    using Page = std::unique_ptr<char[]>;
+
+    List<T>& list_;
+    // the prefix of the file names, unique for the queue
+    std::string prefix_;
+    // the largest number of items in the list
+    int memory_items_;
+    // the number of items in a page
+    int page_items_;
+    // the page collecting the items added after the files
+    Page tail_;
+    int tail_count_;
+    // the files hold the pages from first_page_ to next_page_ - 1
+    int64_t first_page_;
+    int64_t next_page_;
+    // the first page read by another thread, valid while it is read
+    std::future<Page> pending_;
+
+    static std::runtime_error error(const std::string& path) {
+        return std::runtime_error(path + ": " + std::strerror(errno));
+    }
+
+    std::string page_path(int64_t page) const {
+        char name[32];
+        snprintf(name, sizeof(name), "-%012lld.dat",
+                 static_cast<long long>(page));
+        return prefix_ + name;
+    }
+
+    T* items(const Page& page) const {
+        return reinterpret_cast<T*>(page.get());
+    }
+
+    size_t page_bytes() const {
+        return static_cast<size_t>(page_items_) * sizeof(T);
+    }
+
+    // Write the full tail page to the next file
+    void write_tail() {
+        std::string path = page_path(next_page_);
+        int fd = ::open(path.c_str(), O_CREAT | O_WRONLY | O_TRUNC, 0600);
+        if (fd < 0)
+            throw error(path);
+        const char* data = tail_.get();
+        size_t left = page_bytes();
+        while (left > 0) {
+            ssize_t written = ::write(fd, data, left);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0) {
+                ::close(fd);
+                unlink(path.c_str());
+                throw error(path);
+            }
+            data += written;
+            left -= static_cast<size_t>(written);
+        }
+        ::close(fd);
+        next_page_++;
+        tail_count_ = 0;
+    }
+
+    // Read the page file and delete it
+    static Page read_page(const std::string& path, size_t bytes) {
+        Page page(new char[bytes]);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw error(path);
+        char* data = page.get();
+        size_t left = bytes;
+        while (left > 0) {
+            ssize_t got = ::read(fd, data, left);
+            if (got < 0 && errno == EINTR)
+                continue;
+            if (got <= 0) {
+                ::close(fd);
+                throw error(path);
+            }
+            data += got;
+            left -= static_cast<size_t>(got);
+        }
+        ::close(fd);
+        unlink(path.c_str());
+        return page;
+    }
+
+    // Start reading the first file on another thread
+    void prefetch() {
+        if (pending_.valid() || first_page_ == next_page_)
+            return;
+        pending_ = std::async(std::launch::async, read_page,
+                              page_path(first_page_), page_bytes());
+    }
+
+    // Move the pages and the tail to the list while it has room
+    // a page still being read is waited for only if the list is empty
+    void refill() {
+        while (first_page_ < next_page_ &&
+               list_.size() + page_items_ <= memory_items_) {
+            prefetch();
+            if (!list_.is_empty() && pending_.wait_for(
+                    std::chrono::seconds(0)) != std::future_status::ready)
+                break;
+            Page page = pending_.get();
+            first_page_++;
+            list_.push_range(items(page), page_items_);
+        }
+        if (first_page_ == next_page_ && tail_count_ > 0 &&
+                list_.size() + tail_count_ <= memory_items_) {
+            list_.push_range(items(tail_), tail_count_);
+            tail_count_ = 0;
+        }
+        prefetch();
+    }
+
+ public:
+    // Constructor
+    // directory keeps the page files, it is created if missing,
+    // memory_items is the largest number of items in the list, at least
+    // two pages, page_items is the number of items in a page file
+    SpillQueue(List<T>& list, const std::string& directory,
+               int memory_items, int page_items = 4096) :
+            list_(list),
+            memory_items_(memory_items),
+            page_items_(page_items > 0 ? page_items : 1),
+            tail_count_(0),
+            first_page_(0),
+            next_page_(0) {
+        if (memory_items_ < 2 * page_items_)
+            memory_items_ = 2 * page_items_;
+        if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+            throw error(directory);
+        char name[48];
+        snprintf(name, sizeof(name), "/spill-%ld-%d",
+                 static_cast<long>(getpid()), next_spill_queue());
+        prefix_ = directory + name;
+        tail_.reset(new char[page_bytes()]);
+    }
+
+    SpillQueue(const SpillQueue&) = delete;
+    SpillQueue& operator=(const SpillQueue&) = delete;
+
+    // The files left are deleted
+    ~SpillQueue() {
+        if (pending_.valid()) {
+            try {
+                pending_.get();
+                first_page_++;
+            } catch (std::exception&) {
+            }
+        }
+        for (int64_t page = first_page_; page < next_page_; page++)
+            unlink(page_path(page).c_str());
+    }
+
+    bool is_empty() {
+        return list_.is_empty() && first_page_ == next_page_ &&
+               tail_count_ == 0;
+    }
+
+    // The number of items
+    int64_t size() const {
+        return list_.size() + (next_page_ - first_page_) * page_items_ +
+               tail_count_;
+    }
+
+    // The number of pages in the files
+    int64_t spilled_pages() const {
+        return next_page_ - first_page_;
+    }
+
+    void enqueue(T data) {
+        if (first_page_ == next_page_ && tail_count_ == 0 &&
+                list_.size() < memory_items_) {
+            list_.push(std::move(data));
+            return;
+        }
+        // the full page is written first, if writing fails the page is
+        // kept full and the data is not added
+        if (tail_count_ == page_items_)
+            write_tail();
+        std::memcpy(items(tail_) + tail_count_++, &data, sizeof(T));
+    }
+
+    // Enqueue count data from the array
+    void enqueue_bulk(T* data, int count) {
+        for (int i = 0; i < count; i++)
+            enqueue(data[i]);
+    }
+
+    T dequeue() {
+        if (list_.is_empty())
+            refill();
+        if (list_.is_empty())
+            throw std::runtime_error("Queue is empty");
+        T data = list_.pop_front();
+        if (first_page_ < next_page_ || tail_count_ > 0)
+            refill();
+        return data;
+    }
+};
@@ -0,0 +1,65 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+// Queue of items with the type of the list known at compile time
+// we can
+// - get the number of items
+// - add item to the end, or build it in place from the arguments
+// - add several items to the end
+// - get item from the head and move it from the queue
+// - get several items from the head and move them from the queue
+// Like Queue it decorates a list, but the list methods are called by their
+// qualified names, so the calls are not virtual and can be inlined, and the
+// queue itself has no vtable.
+// ListImpl is the type of the list, such as OneWayList<T> or TwoWayList<T>,
+// the list must be of exactly this type - a list derived from it would
+// have its overrides skipped
+template<typename T, typename ListImpl>
+class StaticQueue {
+    ListImpl& list_;
+
+ public:
+    // Constructor
+    template<typename L>
+    explicit StaticQueue(L& list) : list_(list) {
+        static_assert(std::is_same<L, ListImpl>::value,
+                      "the list must be of type ListImpl exactly");
+    }
+
+    void enqueue(T data) {
+        list_.ListImpl::push(std::move(data));
+    }
+
+    // Enqueue the data built from the arguments in the new item
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        list_.ListImpl::emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Enqueue count data from the array, the data are moved out
+    void enqueue_bulk(T* data, int count) {
+        list_.ListImpl::push_range(data, count);
+    }
+
+    bool is_empty() {
+        return list_.ListImpl::is_empty();
+    }
+
+    // The number of items
+    int size() const {
+        return list_.ListImpl::size();
+    }
+
+    T dequeue() {
+        return list_.ListImpl::pop_front();
+    }
+
+    // Dequeue up to count items to the array - return the number of items
+    int dequeue_bulk(T* data, int count) {
+        return list_.ListImpl::pop_range(data, count);
+    }
+};
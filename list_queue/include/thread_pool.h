@@ -0,0 +1,221 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Pool of threads running numbered tasks
+// we can
+// - run task(i) for every i from 0 to count on all threads and wait
+// - add up the results of such tasks in a fixed order
+// Every thread takes the tasks from the front of its own range, a thread
+// with an empty range steals the back half of the range of another thread.
+// The calling thread works too, run must not be called from a task.
+// Several threads can share the pool, their runs go one after another.
+class ThreadPool {
+    // range of tasks of a thread, padded so the ranges of two threads
+    // do not share a cache line
+    struct Range {
+        std::mutex mutex_;
+        int begin_;
+        int end_;
+        char padding_[64];
+        Range() : begin_(0), end_(0) {
+        }
+    };
+
+    // the number of threads including the calling one
+    int size_;
+    // the tasks of every thread
+    std::unique_ptr<Range[]> ranges_;
+    // the threads, the calling thread is not here
+    std::unique_ptr<std::thread[]> threads_;
+    // lets one run at a time use the ranges and the task
+    std::mutex run_mutex_;
+    // the task of the current run
+    void (*call_)(void*, int);
+    void* task_;
+    // the first exception thrown by a task
+    std::exception_ptr error_;
+    // guards the fields below
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    // the number of the current run
+    int64_t generation_;
+    // the number of threads working on the current run
+    int active_;
+    // the threads must exit
+    bool stop_;
+
+    // Take a task from the own range
+    bool take(int self, int* task) {
+        Range& range = ranges_[self];
+        std::lock_guard<std::mutex> lock(range.mutex_);
+        if (range.begin_ == range.end_)
+            return false;
+        *task = range.begin_++;
+        return true;
+    }
+
+    // Move the back half of the range of another thread to the own range
+    // and take its first task
+    bool steal(int self, int* task) {
+        for (int i = 1; i < size_; i++) {
+            Range& victim = ranges_[(self + i) % size_];
+            int begin;
+            int end;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex_);
+                int left = victim.end_ - victim.begin_;
+                if (left == 0)
+                    continue;
+                end = victim.end_;
+                begin = end - (left + 1) / 2;
+                victim.end_ = begin;
+            }
+            Range& range = ranges_[self];
+            std::lock_guard<std::mutex> lock(range.mutex_);
+            range.begin_ = begin + 1;
+            range.end_ = end;
+            *task = begin;
+            return true;
+        }
+        return false;
+    }
+
+    // Run the tasks until there are no tasks left anywhere
+    void work(int self) {
+        int task;
+        while (take(self, &task) || steal(self, &task)) {
+            try {
+                call_(task_, task);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+        }
+    }
+
+    // Wait for the runs and work on them
+    void loop(int self) {
+        int64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this, seen] {
+                    return stop_ || generation_ != seen;
+                });
+                if (stop_)
+                    return;
+                seen = generation_;
+            }
+            work(self);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0)
+                done_.notify_one();
+        }
+    }
+
+    template<typename F>
+    static void call(void* task, int i) {
+        (*static_cast<F*>(task))(i);
+    }
+
+ public:
+    // Constructor
+    // threads is the number of threads including the calling one
+    explicit ThreadPool(int threads = 0) :
+            size_(threads > 0 ? threads :
+                  std::max(1, static_cast<int>(
+                          std::thread::hardware_concurrency()))),
+            ranges_(new Range[size_]),
+            call_(nullptr),
+            task_(nullptr),
+            generation_(0),
+            active_(0),
+            stop_(false) {
+        threads_.reset(new std::thread[size_ - 1]);
+        for (int i = 1; i < size_; i++)
+            threads_[i - 1] = std::thread(&ThreadPool::loop, this, i);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (int i = 0; i < size_ - 1; i++)
+            threads_[i].join();
+    }
+
+    // The number of threads including the calling one
+    int size() const {
+        return size_;
+    }
+
+    // Run task(i) for every i from 0 to count and wait for all of them
+    // the first exception thrown by a task is thrown again here,
+    // a run called by another thread waits for the current one
+    template<typename F>
+    void run(int count, F&& task) {
+        if (count <= 0)
+            return;
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        using Task = typename std::remove_reference<F>::type;
+        call_ = &ThreadPool::call<Task>;
+        task_ = const_cast<void*>(static_cast<const void*>(&task));
+        // split the tasks evenly, the stealing fixes the imbalance
+        for (int i = 0; i < size_; i++) {
+            std::lock_guard<std::mutex> lock(ranges_[i].mutex_);
+            ranges_[i].begin_ = static_cast<int>(
+                    static_cast<int64_t>(count) * i / size_);
+            ranges_[i].end_ = static_cast<int>(
+                    static_cast<int64_t>(count) * (i + 1) / size_);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = nullptr;
+            active_ = size_ - 1;
+            generation_++;
+        }
+        wake_.notify_all();
+        work(0);
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return active_ == 0; });
+            error = error_;
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // Run task(i) for every i from 0 to count and add up the results
+    // in order of i, so the sum does not depend on the scheduling
+    template<typename F>
+    int64_t sum(int count, F&& task) {
+        if (count <= 0)
+            return 0;
+        std::unique_ptr<int64_t[]> results(new int64_t[count]);
+        run(count, [&results, &task](int i) {
+            results[i] = task(i);
+        });
+        int64_t total = 0;
+        for (int i = 0; i < count; i++)
+            total += results[i];
+        return total;
+    }
+};
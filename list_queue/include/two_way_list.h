@@ -2,156 +2,243 @@
 
 #pragma once
 
+#include <iterator>
 #include <memory>
 #include <utility>
 #include <functional>
+#include <stdexcept>
 
+#include "include/block_index.h"
 #include "include/one_way_list.h"
+#include "include/value_index.h"
 
 // List of items
 // we can
+// - get the number of items in O(1)
+// - get the first and the last item in O(1)
+// - get item by index
+// - take the first or the last item out in O(1)
+// - take several first items out
 // - add item to the end
+// - add several items to the end
+// - move all items of the other list to the end
+// - sort the items, merge the other sorted list, erase repeated items,
+//   the items are relinked and not allocated
 // - add item to the head
+// - build item in place at the end or at the head
 // - erase items by index
 // - erase items by value
 // - find the number of items by value
 // - apply the specified function to the items from the first to the last
 // - apply the specified function to the items from the last to the first
-template<typename T>
-class TwoWayList : public OneWayList<T> {
-    using Parent = OneWayList<T>;
-    // the first item
-    std::unique_ptr<ListItemBi<T>> head_;
-    // the last item
-    ListItemBi<T>* last_;
+// - count and apply on all threads of a thread pool
+// - erase all items
+// - get the statistics of the calls
+// - iterate over the items with begin() and end() in both directions,
+//   rbegin() and rend() go from the last to the first
+// The items, the size and the indexes are kept by OneWayList, it sets the
+// back links as it relinks the items, so this list adds and takes the
+// items with the methods of OneWayList. It overrides the erasing and the
+// access by index only, they use the back links.
+// With the block index enabled at and erase_by_index take O(log n) instead
+// of O(n). Without it they walk from the nearer end.
+// With the value index enabled find takes O(1) and erase_by_value takes
+// O(k) for k matching items, the data must not be changed in place then.
+// Alloc is the item allocation policy - HeapAllocator or PoolAllocator
+// Equal is the type of the function to compare two data
+// Stats is the statistics policy - NoStats or ListStats
+template<typename T, typename Alloc = HeapAllocator,
+         typename Equal = std::function<bool(const T&, const T&)>,
+         typename Stats = NoStats>
+class TwoWayList :
+        public OneWayList<T, Alloc, Equal, Stats, ListItemBi<T, Alloc>> {
+    using Parent = OneWayList<T, Alloc, Equal, Stats, ListItemBi<T, Alloc>>;
 
  public:
-    // Constructor
-    explicit TwoWayList(std::function<bool(const T&, const T&)> is_equal) :
-            Parent(is_equal),
-            last_(nullptr) {
+    // item of the list
+    using Node = ListItemBi<T, Alloc>;
+    // creates items
+    using Factory = typename Parent::Factory;
+    // bidirectional iterators over the data
+    using iterator = ListIteratorBi<Node, T>;
+    using const_iterator = ListIteratorBi<Node, const T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+ private:
+    using Parent::equal_;
+    using Parent::head_;
+    using Parent::tail_;
+    using Parent::size_;
+    using Parent::block_index_;
+    using Parent::value_index_;
+    using Parent::stats_;
+
+    // Erase the item, it must be in the list
+    void unlink(Node* cur) {
+        if (block_index_ && cur == head_.get())
+            block_index_->erase_front(cur, cur->next_.get());
+        if (value_index_)
+            value_index_->erase(cur);
+        if (cur->next_)
+            cur->next_->prev_ = cur->prev_;
+        else
+            tail_ = cur->prev_;
+        List<T>::unlink(cur->prev_ ? &cur->prev_->next_ : &head_);
+        size_--;
     }
 
-    // Push data to the end
-    void push(T data) override {
-        if (!head_) {  // empty ?
-            head_ = std::make_unique<ListItemBi<T>>(std::move(data));
-            last_ = head_.get();
+    // Find the item by index, the index must be less than the size
+    // - return the item and its block, the block is -1 without the index,
+    //   and the number of items walked over
+    Node* item_at(int index, int* block, int* walked) {
+        *block = -1;
+        if (block_index_)
+            return block_index_->find(head_.get(), index, block, walked);
+        Node* cur;
+        if (index < size_ / 2) {
+            *walked = index;
+            cur = head_.get();
+            while (index-- > 0)
+                cur = cur->next_.get();
         } else {
-            auto new_item = std::make_unique<ListItemBi<T>>(std::move(data));
-            // add the new item after the current last item
-            ListItemBi<T>* prev = last_;
-            last_ = new_item.get();
-            last_->prev_ = prev;
-            prev->next_ = std::move(new_item);
+            *walked = size_ - 1 - index;
+            cur = tail_;
+            for (int i = size_ - 1; i > index; i--)
+                cur = cur->prev_;
         }
+        return cur;
+    }
+
+ public:
+    // Constructor
+    explicit TwoWayList(Equal is_equal, Factory factory = Factory()) :
+            Parent(is_equal, factory) {
+    }
+
+    // the items are added by OneWayList
+    using Parent::emplace_front;
+
+    // The data of the item by index
+    T& at(int index) {
+        if (index < 0 || index >= size_)
+            throw std::runtime_error("Index out of range");
+        int block;
+        int walked;
+        return item_at(index, &block, &walked)->data_;
+    }
+
+    T& get_last() {
+        if (!tail_)
+            throw std::runtime_error("List is empty");
+        return tail_->data_;
+    }
+
+    // Move the data out of the last item and erase the item
+    T pop_back() {
+        auto probe = stats_.probe(ListOp::kPopBack);
+        if (!tail_)
+            throw std::runtime_error("List is empty");
+        T data(std::move(tail_->data_));
+        if (block_index_ && tail_ != head_.get())
+            block_index_->erase_back(tail_);
+        unlink(tail_);
+        return data;
     }
 
     // Erase item by index
     void erase_by_index(int index) override {
-        int pos = 0;
-        if (!head_)
+        auto probe = stats_.probe(ListOp::kEraseByIndex);
+        if (index < 0 || index >= size_)
             return;
-        // go through all items from the first
-        ListItemBi<T>* prev = nullptr;
-        ListItemBi<T>* cur = head_.get();
-        while (cur) {
-            if (pos == index) {
-                if (pos == 0) {
-                    head_ = std::move(cur->next_);
-                    if (head_)
-                        head_->prev_ = nullptr;
-                    else
-                        last_ = nullptr;
-                } else {
-                    if (cur->next_) {
-                        cur->next_->prev_ = prev;
-                        prev->next_ = std::move(cur->next_);
-                    } else {
-                        last_ = prev;
-                        prev->next_ = nullptr;
-                    }
-                }
-                break;
-            }
-            pos++;
-            prev = cur;
-            cur = cur->next_.get();
-        }
+        int block;
+        int walked;
+        Node* cur = item_at(index, &block, &walked);
+        probe.traversed(walked);
+        if (block >= 0 && index > 0)
+            block_index_->erase(block, cur, cur->next_.get());
+        unlink(cur);
     }
 
     // Erase all item with the specified data
     void erase_by_value(const T& data) override {
-        if (!head_)
-            return;
-        ListItemBi<T>* prev = nullptr;
-        ListItemBi<T>* cur = head_.get();
-        // process head
-        while (cur) {
-            if (Parent::is_equal_(cur->data_, data)) {
-                head_ = std::move(cur->next_);
-                if (head_)
-                    head_->prev_ = nullptr;
-                else
-                    last_ = nullptr;
-                cur = head_.get();
-            } else {
-                prev = cur;
-                cur = cur->next_.get();
-                break;
-            }
-        }
-        // process all other items
-        while (cur) {
-            if (Parent::is_equal_(cur->data_, data)) {
-                if (cur->next_) {
-                    cur->next_->prev_ = prev;
-                    prev->next_ = std::move(cur->next_);
-                    cur = prev->next_.get();
-                } else {
-                    last_ = prev;
-                    prev->next_ = nullptr;
-                    cur = nullptr;
-                }
-            } else {
-                prev = cur;
-                cur = cur->next_.get();
+        auto probe = stats_.probe(ListOp::kEraseByValue);
+        int old_size = size_;
+        if (value_index_) {
+            // erase the matching items only, each is the first of its group
+            while (Node* cur = value_index_->first(data))
+                unlink(cur);
+        } else {
+            probe.traversed(size_);
+            Node* cur = head_.get();
+            while (cur) {
+                Node* next = cur->next_.get();
+                if (equal_(cur->data_, data))
+                    unlink(cur);
+                cur = next;
             }
         }
+        if (block_index_ && size_ != old_size)
+            block_index_->invalidate();
     }
 
     // Push data to the head
     void push_head(T data) {
-        if (!head_) {  // empty ?
-            head_ = std::make_unique<ListItemBi<T>>(std::move(data));
-            last_ = head_.get();
-        } else {
-            auto new_item = std::make_unique<ListItemBi<T>>(std::move(data));
-            // add the new item before the first item
-            head_->prev_ = new_item.get();
-            new_item->next_ = std::move(head_);
-            head_ = std::move(new_item);
-        }
-    }
-
-    // Find all item with the specified data - return the number of such items
-    int find(const T& data) override {
-        return List<T>::template find<ListItemBi<T>>(data, head_);
+        emplace_front(std::move(data));
     }
 
-    // Apply the specified function to all item
-    void apply(std::function<void(const T&)> callback) override {
-        List<T>::template apply<ListItemBi<T>>(callback, head_);
+    // Apply the specified function to all item from the last to the first
+    void apply_reverse(std::function<void(const T&)> callback) {
+        apply_reverse<std::function<void(const T&)>&>(callback);
     }
 
     // Apply the specified function to all item from the last to the first
-    void apply_reverse(std::function<void(const T&)> callback) {
-        if (!last_)
-            return;
-        ListItemBi<T>* cur = last_;
-        while (cur) {
+    // the function is called directly and can be inlined
+    template<typename F>
+    void apply_reverse(F&& callback) {
+        auto probe = stats_.probe(ListOp::kApply);
+        probe.traversed(size_);
+        for (Node* cur = tail_; cur; cur = cur->prev_)
             callback(cur->data_);
-            cur = cur->prev_;
-        }
+    }
+
+    iterator begin() {
+        return iterator(head_.get(), &tail_);
+    }
+
+    iterator end() {
+        return iterator(nullptr, &tail_);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(head_.get(), &tail_);
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr, &tail_);
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
     }
 };
@@ -0,0 +1,470 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <functional>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+#include "include/list.h"
+#include "include/simd_count.h"
+#include "include/thread_pool.h"
+
+// The number of data in an item of the unrolled list by default
+// the data of an item take about four cache lines
+template<typename T>
+constexpr int unrolled_capacity() {
+    return 256 / sizeof(T) > 4 ? static_cast<int>(256 / sizeof(T)) : 4;
+}
+
+// Item for unrolled list - holds up to Capacity data in a row
+template<typename T, int Capacity>
+struct UnrolledItem {
+    // next item
+    std::unique_ptr<UnrolledItem> next_;
+    // position of the first data in the storage, grows when the first data
+    // is taken out so pop_front does not move the rest
+    int first_;
+    // the number of data
+    int count_;
+    // storage for the data, count_ data from first_ are constructed
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data_[Capacity];
+
+    UnrolledItem() : next_(nullptr), first_(0), count_(0) {
+    }
+
+    ~UnrolledItem() {
+        for (int i = 0; i < count_; i++)
+            data()[i].~T();
+    }
+
+    // The first data
+    T* data() {
+        return reinterpret_cast<T*>(data_) + first_;
+    }
+
+    // Is there room for data after the last data
+    bool is_full() const {
+        return first_ + count_ == Capacity;
+    }
+
+    // Move the data to the start of the storage
+    void compact() {
+        if (first_ == 0)
+            return;
+        T* storage = reinterpret_cast<T*>(data_);
+        for (int i = 0; i < count_; i++) {
+            new(storage + i) T(std::move(storage[first_ + i]));
+            storage[first_ + i].~T();
+        }
+        first_ = 0;
+    }
+
+    // Move the data to the end of the other item and destroy it here
+    void move_to(int pos, UnrolledItem* other, int other_pos) {
+        new(other->data() + other_pos) T(std::move(data()[pos]));
+        data()[pos].~T();
+    }
+};
+
+// Forward iterator over the data of an unrolled list
+// V is T for iterator and const T for const_iterator
+template<typename Node, typename V>
+class UnrolledIterator {
+    // current item, nullptr after the last data
+    Node* node_;
+    // position of the data in the item
+    int pos_;
+
+ public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::remove_const<V>::type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = V*;
+    using reference = V&;
+
+    UnrolledIterator() : node_(nullptr), pos_(0) {
+    }
+
+    UnrolledIterator(Node* node, int pos) : node_(node), pos_(pos) {
+    }
+
+    // iterator converts to const_iterator
+    template<typename U, typename = typename std::enable_if<
+            std::is_same<const U, V>::value>::type>
+    UnrolledIterator(const UnrolledIterator<Node, U>& other)  // NOLINT
+            : node_(other.node()), pos_(other.pos()) {
+    }
+
+    Node* node() const {
+        return node_;
+    }
+
+    int pos() const {
+        return pos_;
+    }
+
+    reference operator*() const {
+        return node_->data()[pos_];
+    }
+
+    pointer operator->() const {
+        return node_->data() + pos_;
+    }
+
+    UnrolledIterator& operator++() {
+        if (++pos_ == node_->count_) {
+            node_ = node_->next_.get();
+            pos_ = 0;
+        }
+        return *this;
+    }
+
+    UnrolledIterator operator++(int) {
+        UnrolledIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    template<typename U>
+    bool operator==(const UnrolledIterator<Node, U>& other) const {
+        return node_ == other.node() && pos_ == other.pos();
+    }
+
+    template<typename U>
+    bool operator!=(const UnrolledIterator<Node, U>& other) const {
+        return !(*this == other);
+    }
+};
+
+// List of items each holding many data in a row, so a scan reads
+// contiguous memory instead of chasing a pointer per data
+// we can
+// - get the number of items in O(1)
+// - get the first item
+// - take the first item out
+// - add item to the end
+// - erase items by index
+// - erase items by value
+// - find the number of items by value
+// - apply the specified function to the items
+// - count and apply on all threads of a thread pool, runs of items are
+//   the tasks
+// - erase all items
+// - iterate over the items with begin() and end()
+// Equal is the type of the function to compare two data, with
+// std::equal_to and an arithmetic T find compares the data with SIMD
+// instructions
+// Capacity is the number of data in an item
+template<typename T,
+         typename Equal = std::function<bool(const T&, const T&)>,
+         int Capacity = unrolled_capacity<T>()>
+class UnrolledList : public List<T> {
+ public:
+    // item of the list
+    using Node = UnrolledItem<T, Capacity>;
+    // forward iterators over the data
+    using iterator = UnrolledIterator<Node, T>;
+    using const_iterator = UnrolledIterator<Node, const T>;
+
+ private:
+    // function to compare two data
+    Equal equal_;
+    // the first item
+    std::unique_ptr<Node> head_;
+    // the last item
+    Node* tail_;
+    // the number of data
+    int size_;
+
+    // Count the data in the item with SIMD instructions
+    int find(Node* node, const T& data, std::true_type /* simd */) {
+        return count_equal<T>(node->data(), node->count_, data);
+    }
+
+    int find(Node* node, const T& data, std::false_type /* simd */) {
+        int count = 0;
+        const T* items = node->data();
+        for (int i = 0; i < node->count_; i++) {
+            if (equal_(items[i], data))
+                count++;
+        }
+        return count;
+    }
+
+    // Run visit(item) for every item on all threads of the pool
+    // - return the sum of the results of visit
+    // one walk over the items finds the first item of every task
+    template<typename Visit>
+    int64_t parallel_items(ThreadPool& pool, Visit&& visit) {
+        // the number of items in a task, about 2048 data
+        const int kTaskItems = 2048 / Capacity > 0 ? 2048 / Capacity : 1;
+        int capacity = size_ / (kTaskItems * Capacity) + 1;
+        std::unique_ptr<Node*[]> starts(new Node*[capacity]);
+        int tasks = 0;
+        int items = 0;
+        for (Node* cur = head_.get(); cur; cur = cur->next_.get()) {
+            if (items++ % kTaskItems != 0)
+                continue;
+            if (tasks == capacity) {
+                std::unique_ptr<Node*[]> more(new Node*[capacity * 2]);
+                for (int i = 0; i < tasks; i++)
+                    more[i] = starts[i];
+                starts = std::move(more);
+                capacity *= 2;
+            }
+            starts[tasks++] = cur;
+        }
+        return pool.sum(tasks, [&starts, &visit](int task) {
+            int64_t result = 0;
+            Node* cur = starts[task];
+            for (int i = 0; i < kTaskItems && cur; i++, cur = cur->next_.get())
+                result += visit(cur);
+            return result;
+        });
+    }
+
+    // Erase the empty item after prev, or the first item if prev is nullptr
+    void unlink(Node* prev) {
+        std::unique_ptr<Node>* link = prev ? &prev->next_ : &head_;
+        List<T>::unlink(link);
+        if (!*link)
+            tail_ = prev;
+    }
+
+    // Move the data of the item after node to node if they fit
+    void merge_next(Node* node) {
+        Node* next = node->next_.get();
+        if (!next || node->count_ + next->count_ > Capacity)
+            return;
+        node->compact();
+        for (int i = 0; i < next->count_; i++)
+            next->move_to(i, node, node->count_++);
+        next->count_ = 0;
+        unlink(node);
+    }
+
+ public:
+    // Constructor
+    explicit UnrolledList(Equal is_equal) :
+            List<T>(is_equal),
+            equal_(is_equal),
+            tail_(nullptr),
+            size_(0) {
+    }
+
+    ~UnrolledList() override {
+        List<T>::clear(&head_);
+    }
+
+    bool is_empty() override {
+        return !head_;
+    }
+
+    // The number of data
+    int size() const override {
+        return size_;
+    }
+
+    T& get_first() override {
+        if (!head_)
+            throw std::runtime_error("List is empty");
+        return head_->data()[0];
+    }
+
+    // Move the data out of the first item and erase the item
+    T pop_front() override {
+        if (!head_)
+            throw std::runtime_error("List is empty");
+        T* first = head_->data();
+        T data(std::move(*first));
+        first->~T();
+        head_->first_++;
+        head_->count_--;
+        size_--;
+        if (head_->count_ == 0)
+            unlink(nullptr);
+        return data;
+    }
+
+    // Push data to the end
+    void push(T data) override {
+        if (!tail_ || tail_->is_full()) {
+            auto new_item = std::make_unique<Node>();
+            Node* last = new_item.get();
+            if (tail_)
+                tail_->next_ = std::move(new_item);
+            else
+                head_ = std::move(new_item);
+            tail_ = last;
+        }
+        new(tail_->data() + tail_->count_) T(std::move(data));
+        tail_->count_++;
+        size_++;
+    }
+
+    // Erase item by index
+    void erase_by_index(int index) override {
+        if (index < 0 || index >= size_)
+            return;
+        Node* prev = nullptr;
+        Node* cur = head_.get();
+        // skip the whole items before the index
+        while (cur && index >= cur->count_) {
+            index -= cur->count_;
+            prev = cur;
+            cur = cur->next_.get();
+        }
+        if (!cur)
+            return;
+        // close the gap in the item
+        cur->data()[index].~T();
+        for (int i = index + 1; i < cur->count_; i++)
+            cur->move_to(i, cur, i - 1);
+        cur->count_--;
+        size_--;
+        if (cur->count_ == 0)
+            unlink(prev);
+        else if (cur->count_ < Capacity / 2)
+            merge_next(cur);
+    }
+
+    // Erase all item with the specified data
+    void erase_by_value(const T& data) override {
+        Node* prev = nullptr;
+        Node* cur = head_.get();
+        while (cur) {
+            // pack the other data to the start of the item
+            int count = 0;
+            for (int i = 0; i < cur->count_; i++) {
+                if (equal_(cur->data()[i], data)) {
+                    cur->data()[i].~T();
+                    size_--;
+                } else if (count != i) {
+                    cur->move_to(i, cur, count++);
+                } else {
+                    count++;
+                }
+            }
+            cur->count_ = count;
+            // append the rest to the previous item if it fits
+            if (prev && prev->count_ + cur->count_ <= Capacity)
+                merge_next(prev);
+            else if (cur->count_ == 0)
+                unlink(prev);
+            else
+                prev = cur;
+            cur = prev ? prev->next_.get() : head_.get();
+        }
+    }
+
+    // Find all item with the specified data - return the number of such items
+    int find(const T& data) override {
+        int count = 0;
+        for (Node* cur = head_.get(); cur; cur = cur->next_.get())
+            count += find(cur, data, is_simd_comparable<T, Equal>());
+        return count;
+    }
+
+    // Find all item with the specified data on all threads of the pool
+    // - return the number of such items, it does not depend on the threads
+    int parallel_count(ThreadPool& pool, const T& data) {
+        return static_cast<int>(parallel_items(pool, [this, &data](Node* node) {
+            return find(node, data, is_simd_comparable<T, Equal>());
+        }));
+    }
+
+    // Find all item matching the predicate on all threads of the pool
+    // - return the number of such items
+    template<typename Pred>
+    int parallel_count_if(ThreadPool& pool, Pred&& pred) {
+        return static_cast<int>(parallel_items(pool, [&pred](Node* node) {
+            int count = 0;
+            const T* data = node->data();
+            for (int i = 0; i < node->count_; i++) {
+                if (pred(data[i]))
+                    count++;
+            }
+            return count;
+        }));
+    }
+
+    // Apply the specified function to all item on all threads of the pool
+    // the function is called from several threads at once
+    template<typename F>
+    void parallel_apply(ThreadPool& pool, F&& callback) {
+        parallel_items(pool, [&callback](Node* node) {
+            const T* data = node->data();
+            for (int i = 0; i < node->count_; i++)
+                callback(data[i]);
+            return 0;
+        });
+    }
+
+    // Find all item matching the predicate - return the number of such items
+    template<typename Pred>
+    int find_if(Pred&& pred) {
+        int count = 0;
+        for (Node* cur = head_.get(); cur; cur = cur->next_.get()) {
+            const T* data = cur->data();
+            for (int i = 0; i < cur->count_; i++) {
+                if (pred(data[i]))
+                    count++;
+            }
+        }
+        return count;
+    }
+
+    // Apply the specified function to all item
+    void apply(std::function<void(const T&)> callback) override {
+        apply<std::function<void(const T&)>&>(callback);
+    }
+
+    // Apply the specified function to all item
+    // the function is called directly and can be inlined
+    template<typename F>
+    void apply(F&& callback) {
+        for (Node* cur = head_.get(); cur; cur = cur->next_.get()) {
+            const T* data = cur->data();
+            for (int i = 0; i < cur->count_; i++)
+                callback(data[i]);
+        }
+    }
+
+    // Erase all items
+    void clear() override {
+        List<T>::clear(&head_);
+        tail_ = nullptr;
+        size_ = 0;
+    }
+
+    iterator begin() {
+        return iterator(head_.get(), 0);
+    }
+
+    iterator end() {
+        return iterator();
+    }
+
+    const_iterator begin() const {
+        return const_iterator(head_.get(), 0);
+    }
+
+    const_iterator end() const {
+        return const_iterator();
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+};
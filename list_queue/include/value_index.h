@@ -0,0 +1,220 @@
+// Copyright 2020 for cpplint
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "include/node_pool.h"
+
+// Index of the items of a linked list by their data
+// the items with equal data make a group, the groups are kept in a hash
+// table and the items of a group are kept in list order
+// we can
+// - count the items with the data in O(1)
+// - get the first item with the data in O(1)
+// - register items added to the end or to the head
+// - register erased items, O(1) for the first item of its group and
+//   O(k) for the others, k is the number of items with the same data
+// The data of the items must not be changed while they are indexed.
+template<typename T, typename Node, typename Equal>
+class ValueIndex {
+ public:
+    // function to hash data, equal data must have equal hashes
+    using Hash = std::function<size_t(const T&)>;
+
+ private:
+    // item of a group
+    struct Entry {
+        Node* node_;
+        Entry* next_;
+        explicit Entry(Node* node) : node_(node), next_(nullptr) {
+        }
+    };
+
+    // items with equal data
+    struct Group {
+        // hash of the data
+        size_t hash_;
+        // the number of items
+        int count_;
+        // the first and the last item in list order
+        Entry* first_;
+        Entry* last_;
+        // next group in the bucket
+        Group* next_;
+        explicit Group(size_t hash) :
+            hash_(hash), count_(0), first_(nullptr), last_(nullptr),
+            next_(nullptr) {
+        }
+    };
+
+    // function to hash data
+    Hash hash_;
+    // function to compare two data
+    Equal equal_;
+    // storage for the items and the groups
+    NodePool<Entry> entries_;
+    NodePool<Group> groups_;
+    // the first group of every bucket
+    std::unique_ptr<Group*[]> buckets_;
+    // the number of buckets, a power of two
+    size_t bucket_count_;
+    // the number of groups
+    size_t group_count_;
+
+    // The bucket for the hash
+    // the hash is mixed, so hashes differing in the high bits only
+    // do not share the bucket
+    size_t bucket(size_t hash) const {
+        uint64_t mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(mixed >> 32) & (bucket_count_ - 1);
+    }
+
+    // Find the link to the group with the data
+    // - return the link, it holds nullptr if there is no such group
+    Group** locate(const T& data, size_t hash) {
+        Group** link = &buckets_[bucket(hash)];
+        while (*link && ((*link)->hash_ != hash ||
+                         !equal_((*link)->first_->node_->data_, data)))
+            link = &(*link)->next_;
+        return link;
+    }
+
+    // Allocate the empty buckets
+    void allocate(size_t count) {
+        buckets_.reset(new Group*[count]);
+        bucket_count_ = count;
+        for (size_t i = 0; i < count; i++)
+            buckets_[i] = nullptr;
+    }
+
+    // Double the number of buckets and move the groups
+    void grow() {
+        std::unique_ptr<Group*[]> old = std::move(buckets_);
+        size_t old_count = bucket_count_;
+        allocate(bucket_count_ * 2);
+        for (size_t i = 0; i < old_count; i++) {
+            Group* group = old[i];
+            while (group) {
+                Group* next = group->next_;
+                Group*& head = buckets_[bucket(group->hash_)];
+                group->next_ = head;
+                head = group;
+                group = next;
+            }
+        }
+    }
+
+    // Register the item at the end or at the head of its group
+    void insert(Node* node, bool at_front) {
+        size_t hash = hash_(node->data_);
+        Group** link = locate(node->data_, hash);
+        Entry* entry = entries_.create(node);
+        if (!*link) {
+            try {
+                *link = groups_.create(hash);
+            } catch (...) {
+                entries_.destroy(entry);
+                throw;
+            }
+            group_count_++;
+        }
+        Group* group = *link;
+        if (!group->first_) {
+            group->first_ = group->last_ = entry;
+        } else if (at_front) {
+            entry->next_ = group->first_;
+            group->first_ = entry;
+        } else {
+            group->last_->next_ = entry;
+            group->last_ = entry;
+        }
+        group->count_++;
+        if (group_count_ > bucket_count_)
+            grow();
+    }
+
+ public:
+    // Constructor
+    ValueIndex(Hash hash, Equal equal) :
+            hash_(hash),
+            equal_(equal),
+            bucket_count_(0),
+            group_count_(0) {
+        allocate(16);
+    }
+
+    ValueIndex(const ValueIndex&) = delete;
+    ValueIndex& operator=(const ValueIndex&) = delete;
+
+    // The number of items with the data
+    int count(const T& data) {
+        Group* group = *locate(data, hash_(data));
+        return group ? group->count_ : 0;
+    }
+
+    // The first item with the data, nullptr if there is no such item
+    Node* first(const T& data) {
+        Group* group = *locate(data, hash_(data));
+        return group ? group->first_->node_ : nullptr;
+    }
+
+    // The item has been added to the end
+    void push_back(Node* node) {
+        insert(node, false);
+    }
+
+    // The item has been added to the head
+    void push_front(Node* node) {
+        insert(node, true);
+    }
+
+    // The item is about to be erased
+    void erase(Node* node) {
+        Group** link = locate(node->data_, hash_(node->data_));
+        Group* group = *link;
+        if (!group)
+            return;
+        // the erased item is usually the first one of its group
+        Entry* prev = nullptr;
+        Entry* entry = group->first_;
+        while (entry && entry->node_ != node) {
+            prev = entry;
+            entry = entry->next_;
+        }
+        if (!entry)
+            return;
+        if (prev)
+            prev->next_ = entry->next_;
+        else
+            group->first_ = entry->next_;
+        if (group->last_ == entry)
+            group->last_ = prev;
+        entries_.destroy(entry);
+        if (--group->count_ == 0) {
+            *link = group->next_;
+            groups_.destroy(group);
+            group_count_--;
+        }
+    }
+
+    // Forget all items
+    void reset() {
+        for (size_t i = 0; i < bucket_count_; i++) {
+            while (buckets_[i]) {
+                Group* group = buckets_[i];
+                buckets_[i] = group->next_;
+                while (group->first_) {
+                    Entry* entry = group->first_;
+                    group->first_ = entry->next_;
+                    entries_.destroy(entry);
+                }
+                groups_.destroy(group);
+            }
+        }
+        group_count_ = 0;
+    }
+};
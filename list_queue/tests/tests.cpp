@@ -1,9 +1,37 @@
 // Copyright 2020 for cpplint
 
+#include <dirent.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <string>
+#include <chrono>
 #include "include/queue.h"
+#include "include/static_queue.h"
+#include "include/deque.h"
+#include "include/priority_queue.h"
+#include "include/blocking_queue.h"
 #include "include/one_way_list.h"
 #include "include/two_way_list.h"
+#include "include/node_pool.h"
+#include "include/concurrent_queue.h"
+#include "include/ring_buffer.h"
+#include "include/unrolled_list.h"
+#include "include/simd_count.h"
+#include "include/thread_pool.h"
+#include "include/intrusive_list.h"
+#include "include/list_stats.h"
+#include "include/persistent_queue.h"
+#include "include/spill_queue.h"
 
 class Foo {
     int a_;
@@ -45,6 +73,43 @@ bool is_equal_pointers(const T& data1, const T& data2) {
     return *data1 == *data2;
 }
 
+// number of failed checks
+int failures = 0;
+
+// Report the failed check
+void check(bool condition, const char* message) {
+    if (!condition) {
+        std::cout << "FAILED: " << message << std::endl;
+        failures++;
+    }
+}
+
+// Collect the list items into the array - return the number of items
+template<typename L>
+int collect(L& list, int* items, int max_count) {
+    int count = 0;
+    list.apply([&](const int& data) {
+        if (count < max_count)
+            items[count] = data;
+        count++;
+    });
+    return count;
+}
+
+// Random numbers less than range, the same ones on every run
+class Random {
+    unsigned seed_;
+
+ public:
+    explicit Random(unsigned seed) : seed_(seed) {
+    }
+
+    int operator()(int range) {
+        seed_ = seed_ * 1103515245u + 12345u;
+        return static_cast<int>((seed_ >> 8) % range);
+    }
+};
+
 void test_QueueInt_OneWayList() {
     typedef int DataType;
     // create list
@@ -333,6 +398,1838 @@ void test_TwoWayList_Pointer() {
     two_list.erase_by_index(0);
 }
 
+void test_OneWayList_Tail() {
+    typedef int DataType;
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    int items[8];
+    // erase the last item by index and push after it
+    one_list.push(1);
+    one_list.push(2);
+    one_list.push(3);
+    one_list.erase_by_index(2);
+    one_list.push(4);
+    check(collect(one_list, items, 8) == 3 && items[0] == 1 &&
+          items[1] == 2 && items[2] == 4, "push after erase_by_index");
+    // erase the last item by value and push after it
+    one_list.erase_by_value(4);
+    one_list.push(5);
+    check(collect(one_list, items, 8) == 3 && items[2] == 5,
+          "push after erase_by_value of the last item");
+    // erase everything and push into the empty list
+    one_list.erase_by_value(1);
+    one_list.erase_by_value(2);
+    one_list.erase_by_value(5);
+    check(one_list.is_empty(), "erase_by_value of all items");
+    one_list.push(6);
+    one_list.push(7);
+    check(collect(one_list, items, 8) == 2 && items[0] == 6 &&
+          items[1] == 7, "push after erase of all items");
+    one_list.erase_by_index(0);
+    one_list.erase_by_index(0);
+    one_list.push(8);
+    check(collect(one_list, items, 8) == 1 && items[0] == 8,
+          "push after erase_by_index of all items");
+}
+
+void test_List_Clear() {
+    typedef int DataType;
+    int items[8];
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    one_list.push(1);
+    one_list.push(2);
+    one_list.clear();
+    check(one_list.is_empty(), "OneWayList is empty after clear");
+    one_list.push(3);
+    check(collect(one_list, items, 8) == 1 && items[0] == 3,
+          "OneWayList push after clear");
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    two_list.push(1);
+    two_list.push_head(2);
+    two_list.clear();
+    check(collect(two_list, items, 8) == 0, "TwoWayList is empty after clear");
+    two_list.push(3);
+    two_list.push_head(4);
+    check(collect(two_list, items, 8) == 2 && items[0] == 4 &&
+          items[1] == 3, "TwoWayList push after clear");
+}
+
+void test_List_DestroyLong() {
+    typedef int DataType;
+    const int count = 10000000;
+    {
+        OneWayList<DataType> one_list(is_equal<DataType>);
+        for (int i = 0; i < count; i++)
+            one_list.push(i);
+    }
+    {
+        TwoWayList<DataType> two_list(is_equal<DataType>);
+        for (int i = 0; i < count; i++)
+            two_list.push(i);
+    }
+    {
+        OneWayList<DataType> one_list(is_equal<DataType>);
+        for (int i = 0; i < count; i++)
+            one_list.push(i);
+        one_list.clear();
+        check(one_list.is_empty(), "clear of the long list");
+    }
+}
+
+void test_List_NodePool() {
+    typedef int DataType;
+    int items[8];
+    NodePool<OneWayList<DataType, PoolAllocator>::Node> one_pool(2);
+    OneWayList<DataType, PoolAllocator> one_list(is_equal<DataType>,
+                                                 one_pool);
+    Queue<DataType> queue(one_list);
+    queue.enqueue(1);
+    queue.enqueue(2);
+    queue.enqueue(3);
+    check(queue.dequeue() == 1 && queue.dequeue() == 2,
+          "dequeue from the pooled list");
+    queue.enqueue(4);
+    queue.enqueue(5);
+    check(one_pool.pooled() == 3 && one_pool.reused() == 2,
+          "pooled list reuses the erased items");
+    check(collect(one_list, items, 8) == 3 && items[0] == 3 &&
+          items[1] == 4 && items[2] == 5, "pooled list keeps the order");
+
+    NodePool<TwoWayList<DataType, PoolAllocator>::Node> two_pool;
+    {
+        TwoWayList<DataType, PoolAllocator> two_list(is_equal<DataType>,
+                                                     two_pool);
+        two_list.push(1);
+        two_list.push_head(2);
+        two_list.push(1);
+        two_list.erase_by_value(1);
+        two_list.push(3);
+        check(collect(two_list, items, 8) == 2 && items[0] == 2 &&
+              items[1] == 3, "pooled two way list keeps the order");
+    }
+    check(two_pool.pooled() == 3 && two_pool.reused() == 1,
+          "pooled two way list reuses the erased items");
+
+    typedef std::unique_ptr<Foo> PointerType;
+    NodePool<OneWayList<PointerType, PoolAllocator>::Node> pointer_pool;
+    OneWayList<PointerType, PoolAllocator> pointer_list(
+            is_equal_pointers<PointerType>, pointer_pool);
+    pointer_list.push(std::make_unique<Foo>(1));
+    pointer_list.push(std::make_unique<Foo>(2));
+    pointer_list.erase_by_index(0);
+    check(pointer_list.find(std::make_unique<Foo>(2)) == 1,
+          "pooled list of pointers");
+}
+
+void test_ConcurrentQueue() {
+    ConcurrentQueue<int> queue;
+    check(queue.is_empty(), "new concurrent queue is empty");
+    queue.enqueue(1);
+    queue.enqueue(2);
+    check(!queue.is_empty(), "concurrent queue is not empty after enqueue");
+    int data = 0;
+    check(queue.dequeue() == 1 && queue.try_dequeue(&data) && data == 2,
+          "concurrent queue keeps the order");
+    check(!queue.try_dequeue(&data), "try_dequeue from the empty queue");
+    bool thrown = false;
+    try {
+        queue.dequeue();
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(thrown, "dequeue from the empty concurrent queue throws");
+
+    ConcurrentQueue<std::unique_ptr<Foo>> pointer_queue;
+    pointer_queue.enqueue(std::make_unique<Foo>(1));
+    pointer_queue.enqueue(std::make_unique<Foo>(2));
+    check(*pointer_queue.dequeue() == Foo(1), "concurrent queue of pointers");
+}
+
+void test_ConcurrentQueue_Threads() {
+    const int threads = 4;
+    const int count = 20000;
+    ConcurrentQueue<int> queue;
+    std::atomic<int64_t> sum(0);
+    std::atomic<int> taken(0);
+    std::unique_ptr<std::thread[]> producers(new std::thread[threads]);
+    std::unique_ptr<std::thread[]> consumers(new std::thread[threads]);
+    for (int t = 0; t < threads; t++) {
+        producers[t] = std::thread([&queue, t]() {
+            for (int i = 0; i < count; i++)
+                queue.enqueue(t * count + i);
+        });
+        consumers[t] = std::thread([&]() {
+            int data = 0;
+            while (taken.load() < threads * count) {
+                if (queue.try_dequeue(&data)) {
+                    sum += data;
+                    taken++;
+                }
+            }
+        });
+    }
+    for (int t = 0; t < threads; t++) {
+        producers[t].join();
+        consumers[t].join();
+    }
+    int64_t total = static_cast<int64_t>(threads) * count;
+    check(taken.load() == total && sum.load() == total * (total - 1) / 2,
+          "concurrent queue passes every item exactly once");
+    check(queue.is_empty(), "concurrent queue is empty after the threads");
+}
+
+void test_RingBuffer() {
+    typedef int DataType;
+    int items[8];
+    RingBuffer<DataType> ring(is_equal<DataType>, 3, FullPolicy::kFail);
+    check(ring.capacity() == 4, "ring capacity is rounded to a power of two");
+    Queue<DataType> queue(ring);
+    check(queue.is_empty(), "new ring is empty");
+    for (int i = 1; i <= 4; i++)
+        queue.enqueue(i);
+    check(!ring.try_push(5), "push to the full ring fails");
+    check(queue.dequeue() == 1 && queue.dequeue() == 2,
+          "queue over the ring keeps the order");
+    ring.push(5);
+    ring.push(6);
+    check(collect(ring, items, 8) == 4 && items[0] == 3 && items[3] == 6,
+          "ring wraps around");
+    ring.erase_by_index(2);
+    check(collect(ring, items, 8) == 3 && items[0] == 3 && items[1] == 4 &&
+          items[2] == 6, "erase_by_index in the ring");
+    ring.push(4);
+    ring.erase_by_value(4);
+    check(collect(ring, items, 8) == 2 && items[0] == 3 && items[1] == 6 &&
+          ring.find(4) == 0 && ring.find(6) == 1, "erase_by_value in the ring");
+    ring.clear();
+    check(ring.is_empty() && ring.size() == 0, "ring is empty after clear");
+
+    RingBuffer<DataType> overwrite(is_equal<DataType>, 2,
+                                   FullPolicy::kOverwrite);
+    for (int i = 1; i <= 5; i++)
+        overwrite.push(i);
+    check(collect(overwrite, items, 8) == 2 && items[0] == 4 &&
+          items[1] == 5, "overwrite erases the oldest items");
+
+    typedef std::unique_ptr<Foo> PointerType;
+    RingBuffer<PointerType> pointers(is_equal_pointers<PointerType>, 2);
+    Queue<PointerType> pointer_queue(pointers);
+    pointer_queue.enqueue(std::make_unique<Foo>(1));
+    pointer_queue.enqueue(std::make_unique<Foo>(2));
+    check(*pointer_queue.dequeue() == Foo(1), "ring of pointers");
+}
+
+void test_RingBuffer_Threads() {
+    const int count = 100000;
+    for (int policy = 0; policy < 2; policy++) {
+        RingBuffer<int> ring(is_equal<int>, 16,
+                             policy ? FullPolicy::kFail : FullPolicy::kBlock);
+        std::thread producer([&ring]() {
+            for (int i = 0; i < count; i++) {
+                while (!ring.try_push(i))
+                    std::this_thread::yield();
+            }
+        });
+        bool ordered = true;
+        for (int i = 0; i < count; i++) {
+            while (ring.is_empty())
+                std::this_thread::yield();
+            ordered = ordered && ring.get_first() == i;
+            ring.erase_by_index(0);
+        }
+        producer.join();
+        check(ordered && ring.is_empty(), "ring passes items between threads");
+    }
+    // the consumer only takes items while the producer overwrites them
+    RingBuffer<int> ring(is_equal<int>, 8, FullPolicy::kOverwrite);
+    std::atomic<bool> done(false);
+    std::thread producer([&]() {
+        for (int i = 0; i < count; i++)
+            ring.push(i);
+        done = true;
+    });
+    bool ordered = true;
+    int last = -1;
+    while (!done.load() || !ring.is_empty()) {
+        int data = 0;
+        if (!ring.try_pop(&data)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && data > last;
+        last = data;
+    }
+    producer.join();
+    check(ordered, "overwriting ring keeps the order between threads");
+}
+
+void test_List_Visitors() {
+    typedef int DataType;
+    OneWayList<DataType, HeapAllocator, std::equal_to<DataType>> one_list(
+            (std::equal_to<DataType>()));
+    TwoWayList<DataType, HeapAllocator, std::equal_to<DataType>> two_list(
+            (std::equal_to<DataType>()));
+    for (int i = 0; i < 10; i++) {
+        one_list.push(i % 3);
+        two_list.push(i % 3);
+    }
+    check(one_list.find(0) == 4 && two_list.find(2) == 3,
+          "find with the comparator type");
+    check(one_list.find_if([](int data) { return data > 0; }) == 6 &&
+          two_list.find_if([](int data) { return data == 1; }) == 3,
+          "find_if with the predicate");
+    int sum = 0;
+    one_list.apply([&sum](int data) { sum += data; });
+    check(sum == 9, "apply with the lambda");
+    int first = -1;
+    two_list.apply_reverse([&first](int data) {
+        if (first < 0)
+            first = data;
+    });
+    check(first == 0, "apply_reverse with the lambda");
+    // the std::function api still works
+    std::function<void(const int&)> callback = [&sum](const int& data) {
+        sum -= data;
+    };
+    one_list.apply(callback);
+    check(sum == 0, "apply with std::function");
+    two_list.erase_by_value(0);
+    check(two_list.find(0) == 0, "erase_by_value with the comparator type");
+}
+
+void test_List_Iterators() {
+    typedef int DataType;
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    check(one_list.begin() == one_list.end() &&
+          two_list.begin() == two_list.end(), "empty list iterators");
+    for (int i = 1; i <= 5; i++) {
+        one_list.push(i);
+        two_list.push(i);
+    }
+    check(std::accumulate(one_list.begin(), one_list.end(), 0) == 15 &&
+          std::accumulate(two_list.cbegin(), two_list.cend(), 0) == 15,
+          "accumulate over the list");
+    auto found = std::find_if(one_list.begin(), one_list.end(),
+                              [](int data) { return data > 3; });
+    check(found != one_list.end() && *found == 4, "find_if over the list");
+    check(std::distance(two_list.begin(), two_list.end()) == 5,
+          "distance over the list");
+    // change the data through the iterator
+    for (auto& data : one_list)
+        data *= 10;
+    check(one_list.find(30) == 1, "change the data through the iterator");
+    // go back from the end
+    auto last = two_list.end();
+    --last;
+    check(*last == 5 && *std::prev(last) == 4, "decrement the iterator");
+    int reversed[5];
+    std::copy(two_list.rbegin(), two_list.rend(), reversed);
+    check(reversed[0] == 5 && reversed[4] == 1, "reverse iterators");
+    const TwoWayList<DataType>& const_list = two_list;
+    TwoWayList<DataType>::const_iterator first = two_list.begin();
+    check(first == const_list.begin() && *const_list.rbegin() == 5,
+          "const iterators");
+}
+
+void test_UnrolledList() {
+    typedef int DataType;
+    int items[16];
+    UnrolledList<DataType, std::function<bool(const int&, const int&)>, 4>
+            list(is_equal<DataType>);
+    check(list.is_empty() && list.begin() == list.end(),
+          "new unrolled list is empty");
+    for (int i = 0; i < 10; i++)
+        list.push(i);
+    check(collect(list, items, 16) == 10 && items[0] == 0 && items[9] == 9,
+          "push to the unrolled list");
+    list.erase_by_index(5);
+    list.erase_by_index(0);
+    list.erase_by_index(7);
+    check(collect(list, items, 16) == 7 && items[0] == 1 && items[4] == 6 &&
+          items[6] == 8, "erase_by_index in the unrolled list");
+    list.push(3);
+    list.push(10);
+    list.erase_by_value(3);
+    check(collect(list, items, 16) == 7 && items[1] == 2 && items[2] == 4 &&
+          items[6] == 10 && list.find(3) == 0,
+          "erase_by_value in the unrolled list");
+    check(list.find_if([](int data) { return data % 2 == 0; }) == 5,
+          "find_if in the unrolled list");
+    int sum = 0;
+    for (int data : list)
+        sum += data;
+    check(sum == 1 + 2 + 4 + 6 + 7 + 8 + 10, "iterate over the unrolled list");
+    Queue<DataType> queue(list);
+    check(queue.dequeue() == 1 && queue.dequeue() == 2,
+          "queue over the unrolled list");
+    list.clear();
+    check(list.is_empty(), "unrolled list is empty after clear");
+    list.push(1);
+    check(list.get_first() == 1, "push after clear");
+
+    typedef std::unique_ptr<Foo> PointerType;
+    UnrolledList<PointerType> pointers(is_equal_pointers<PointerType>);
+    for (int i = 0; i < 100; i++)
+        pointers.push(std::make_unique<Foo>(i % 10));
+    pointers.erase_by_value(std::make_unique<Foo>(3));
+    pointers.erase_by_index(0);
+    check(pointers.find(std::make_unique<Foo>(3)) == 0 &&
+          pointers.find(std::make_unique<Foo>(0)) == 9 &&
+          *pointers.get_first() == Foo(1), "unrolled list of pointers");
+}
+
+// Push 1, 2, 3 and take them back with pop_front
+template<typename L>
+void check_pop_front(L& list, const char* message) {
+    list.push(1);
+    list.push(2);
+    list.push(3);
+    bool ordered = list.pop_front() == 1 && list.pop_front() == 2;
+    list.push(4);
+    ordered = ordered && list.pop_front() == 3 && list.pop_front() == 4;
+    bool thrown = false;
+    try {
+        list.pop_front();
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    list.push(5);
+    check(ordered && thrown && list.get_first() == 5, message);
+}
+
+void test_List_PopFront() {
+    typedef int DataType;
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    check_pop_front(one_list, "pop_front from OneWayList");
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    two_list.push(0);
+    two_list.pop_front();
+    two_list.push_head(1);
+    two_list.push(2);
+    check(two_list.pop_front() == 1 && two_list.pop_front() == 2,
+          "pop_front from TwoWayList");
+    int reversed = 0;
+    two_list.push(3);
+    two_list.apply_reverse([&reversed](int data) { reversed += data; });
+    check(reversed == 3, "TwoWayList links after pop_front");
+    RingBuffer<DataType> ring(is_equal<DataType>, 4);
+    check_pop_front(ring, "pop_front from RingBuffer");
+    UnrolledList<DataType, std::function<bool(const int&, const int&)>, 2>
+            unrolled(is_equal<DataType>);
+    check_pop_front(unrolled, "pop_front from UnrolledList");
+    for (int i = 0; i < 7; i++)
+        unrolled.push(i);
+    unrolled.pop_front();
+    unrolled.erase_by_index(1);
+    unrolled.erase_by_value(3);
+    int items[8];
+    check(collect(unrolled, items, 8) == 5 && items[0] == 0 &&
+          items[1] == 2 && items[2] == 4 && items[4] == 6,
+          "UnrolledList erase after pop_front");
+}
+
+void test_List_Bulk() {
+    typedef int DataType;
+    int items[16];
+    int data[] = {1, 2, 3, 4, 5};
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    Queue<DataType> queue(one_list);
+    queue.enqueue(0);
+    queue.enqueue_bulk(data, 5);
+    queue.enqueue(6);
+    check(collect(one_list, items, 16) == 7 && items[0] == 0 &&
+          items[5] == 5 && items[6] == 6, "enqueue_bulk to OneWayList");
+    int taken[8];
+    check(queue.dequeue_bulk(taken, 3) == 3 && taken[0] == 0 &&
+          taken[2] == 2, "dequeue_bulk from OneWayList");
+    check(queue.dequeue_bulk(taken, 8) == 4 && taken[3] == 6 &&
+          queue.is_empty(), "dequeue_bulk of the rest");
+    queue.enqueue(7);
+    check(queue.dequeue() == 7, "enqueue after dequeue_bulk");
+
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    two_list.push_range(data, 3);
+    two_list.push_head(0);
+    int reversed[8];
+    int count = 0;
+    two_list.apply_reverse([&](int item) { reversed[count++] = item; });
+    check(count == 4 && reversed[0] == 3 && reversed[3] == 0,
+          "push_range to TwoWayList");
+    check(two_list.pop_range(taken, 2) == 2 && taken[0] == 0 &&
+          taken[1] == 1 && two_list.pop_front() == 2,
+          "pop_range from TwoWayList");
+
+    // splice
+    OneWayList<DataType> one_other(is_equal<DataType>);
+    one_list.push(1);
+    one_other.push(2);
+    one_other.push(3);
+    one_list.splice_back(one_other);
+    one_list.push(4);
+    check(collect(one_list, items, 16) == 4 && items[1] == 2 &&
+          items[3] == 4 && one_other.is_empty(), "splice_back of OneWayList");
+    one_other.push(5);
+    check(collect(one_other, items, 16) == 1, "push after splice_back");
+
+    TwoWayList<DataType> two_other(is_equal<DataType>);
+    two_other.push(4);
+    two_other.push(5);
+    two_list.splice_back(two_other);
+    two_list.splice_back(two_other);
+    count = 0;
+    two_list.apply_reverse([&](int item) { reversed[count++] = item; });
+    check(count == 3 && reversed[0] == 5 && reversed[2] == 3 &&
+          collect(two_other, items, 16) == 0, "splice_back of TwoWayList");
+
+    // default implementation and move-only data
+    RingBuffer<DataType> ring(is_equal<DataType>, 8);
+    Queue<DataType> ring_queue(ring);
+    ring_queue.enqueue_bulk(data, 5);
+    check(ring_queue.dequeue_bulk(taken, 8) == 5 && taken[4] == 5,
+          "bulk operations of RingBuffer");
+    typedef std::unique_ptr<Foo> PointerType;
+    OneWayList<PointerType> pointers(is_equal_pointers<PointerType>);
+    PointerType pointer_data[2] = {std::make_unique<Foo>(1),
+                                   std::make_unique<Foo>(2)};
+    pointers.push_range(pointer_data, 2);
+    PointerType pointer_taken[2];
+    check(!pointer_data[0] && pointers.pop_range(pointer_taken, 2) == 2 &&
+          *pointer_taken[1] == Foo(2), "bulk operations with pointers");
+}
+
+void test_List_Size() {
+    typedef int DataType;
+    int data[] = {1, 2, 3, 2, 5};
+    int taken[8];
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    Queue<DataType> queue(one_list);
+    queue.enqueue(0);
+    queue.enqueue_bulk(data, 5);
+    check(queue.size() == 6, "size after enqueue");
+    one_list.erase_by_value(2);
+    one_list.erase_by_index(3);
+    one_list.erase_by_index(10);
+    check(one_list.size() == 3, "size after erase");
+    queue.dequeue_bulk(taken, 2);
+    check(queue.size() == 1, "size after dequeue");
+    OneWayList<DataType> one_other(is_equal<DataType>);
+    one_other.push(7);
+    one_other.push(8);
+    one_list.splice_back(one_other);
+    check(one_list.size() == 3 && one_other.size() == 0,
+          "size after splice_back");
+    one_list.clear();
+    check(one_list.size() == 0, "size after clear");
+
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    two_list.push_range(data, 5);
+    two_list.push_head(0);
+    two_list.erase_by_value(2);
+    two_list.erase_by_index(1);
+    two_list.pop_front();
+    check(two_list.size() == 2 && two_list.at(0) == 3 && two_list.at(1) == 5,
+          "size of TwoWayList");
+
+    UnrolledList<DataType, std::function<bool(const int&, const int&)>, 2>
+            unrolled(is_equal<DataType>);
+    unrolled.push_range(data, 5);
+    unrolled.erase_by_value(2);
+    unrolled.erase_by_index(0);
+    unrolled.erase_by_index(5);
+    unrolled.pop_front();
+    check(unrolled.size() == 1, "size of UnrolledList");
+
+    RingBuffer<DataType> ring(is_equal<DataType>, 8);
+    List<DataType>& ring_list = ring;
+    ring_list.push_range(data, 5);
+    ring_list.erase_by_value(2);
+    check(ring_list.size() == 3, "size of RingBuffer");
+}
+
+template<typename T>
+bool push_head(OneWayList<T>&, T) {
+    return false;
+}
+
+template<typename T>
+bool push_head(TwoWayList<T>& list, T data) {
+    list.push_head(data);
+    return true;
+}
+
+// Run random operations on the list and on an array, compare the results
+template<typename L>
+void check_block_index(L& list, const char* message) {
+    const int kMax = 6000;
+    std::unique_ptr<int[]> model(new int[kMax]);
+    int size = 0;
+    Random random(12345);
+    bool ok = true;
+    for (int step = 0; step < 20000 && ok; step++) {
+        int operation = random(100);
+        if (size < kMax - 8 && operation < 40) {
+            list.push(step);
+            model[size++] = step;
+        } else if (size < kMax - 8 && operation < 45) {
+            int data[4] = {step, step + 1, step + 2, step + 3};
+            list.push_range(data, 4);
+            for (int i = 0; i < 4; i++)
+                model[size++] = step + i;
+        } else if (size < kMax - 8 && operation < 52) {
+            if (push_head(list, step)) {
+                for (int i = size; i > 0; i--)
+                    model[i] = model[i - 1];
+                model[0] = step;
+                size++;
+            }
+        } else if (size > 0 && operation < 65) {
+            ok = list.pop_front() == model[0];
+            for (int i = 1; i < size; i++)
+                model[i - 1] = model[i];
+            size--;
+        } else if (size > 0 && operation < 85) {
+            int index = random(size);
+            list.erase_by_index(index);
+            for (int i = index + 1; i < size; i++)
+                model[i - 1] = model[i];
+            size--;
+        } else if (size > 0 && operation < 86) {
+            int value = model[random(size)];
+            list.erase_by_value(value);
+            int count = 0;
+            for (int i = 0; i < size; i++) {
+                if (model[i] != value)
+                    model[count++] = model[i];
+            }
+            size = count;
+        } else if (size > 0) {
+            int index = random(size);
+            ok = list.at(index) == model[index];
+        }
+        ok = ok && list.size() == size;
+    }
+    for (int i = 0; i < size && ok; i++)
+        ok = list.at(i) == model[i];
+    bool thrown = false;
+    try {
+        list.at(size);
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(ok && thrown, message);
+}
+
+// Interleave the adds to the head with at and erase_by_index on a long
+// indexed list, the list holds -heads..-1 followed by 0..tail - 1
+template<typename L, typename AddHead>
+bool check_front_growth(L& list, AddHead add_head) {
+    const int kCount = 200000;
+    list.enable_block_index();
+    for (int i = 0; i < kCount; i++)
+        list.push(i);
+    Random random(4242);
+    int heads = 0;
+    int tail = kCount;
+    bool ok = true;
+    for (int step = 0; step < 100000 && ok; step++) {
+        add_head(list, -++heads);
+        int index = random(list.size());
+        ok = list.at(index) == index - heads;
+        if (step % 3 == 0) {
+            list.erase_by_index(0);
+            heads--;
+        } else if (step % 3 == 1) {
+            list.erase_by_index(list.size() - 1);
+            tail--;
+        }
+        ok = ok && list.size() == heads + tail;
+    }
+    for (int i = 0; i < list.size() && ok; i += 101)
+        ok = list.at(i) == i - heads;
+    return ok;
+}
+
+void test_List_BlockIndex() {
+    typedef int DataType;
+    OneWayList<DataType> one_plain(is_equal<DataType>);
+    check_block_index(one_plain, "at of OneWayList");
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    one_list.enable_block_index();
+    check_block_index(one_list, "block index of OneWayList");
+    TwoWayList<DataType> two_plain(is_equal<DataType>);
+    check_block_index(two_plain, "at of TwoWayList");
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    two_list.enable_block_index();
+    check_block_index(two_list, "block index of TwoWayList");
+
+    // long list, used as a queue with the index enabled
+    const int kCount = 1000000;
+    OneWayList<DataType> long_list(is_equal<DataType>);
+    long_list.enable_block_index();
+    for (int i = 0; i < kCount; i++)
+        long_list.push(i);
+    bool ok = true;
+    for (int i = 0; i < kCount; i += 997)
+        ok = ok && long_list.at(i) == i;
+    for (int i = 0; i < 1000; i++)
+        long_list.erase_by_index(kCount / 2);
+    ok = ok && long_list.at(kCount / 2) == kCount / 2 + 1000 &&
+         long_list.at(kCount / 2 - 1) == kCount / 2 - 1;
+    for (int i = 0; i < kCount / 2; i++)
+        ok = ok && long_list.pop_front() == i;
+    ok = ok && long_list.at(0) == kCount / 2 + 1000 &&
+         long_list.size() == kCount / 2 - 1000;
+    check(ok, "block index of a long list");
+
+    // long lists growing at the head, the index keeps up without rebuilds
+    TwoWayList<DataType> two_long(is_equal<DataType>);
+    OneWayList<DataType> one_long(is_equal<DataType>);
+    check(check_front_growth(two_long, [](TwoWayList<DataType>& list,
+                                          DataType data) {
+              list.push_head(data);
+          }) && check_front_growth(one_long, [](OneWayList<DataType>& list,
+                                                DataType data) {
+              list.emplace_front(data);
+          }), "block index of a list growing at the head");
+}
+
+// Run random operations on the indexed list and on an array,
+// compare the numbers of items found by value
+template<typename L>
+void check_value_index(L& list, const char* message) {
+    const int kMax = 3000;
+    const int kValues = 50;
+    std::unique_ptr<int[]> model(new int[kMax]);
+    int size = 0;
+    Random random(54321);
+    auto count = [&model, &size](int value) {
+        int found = 0;
+        for (int i = 0; i < size; i++)
+            found += model[i] == value;
+        return found;
+    };
+    bool ok = true;
+    for (int step = 0; step < 20000 && ok; step++) {
+        int operation = random(100);
+        int value = random(kValues);
+        if (size < kMax - 8 && operation < 35) {
+            list.push(value);
+            model[size++] = value;
+        } else if (size < kMax - 8 && operation < 40) {
+            int data[3] = {value, value, (value + 1) % kValues};
+            list.push_range(data, 3);
+            for (int i = 0; i < 3; i++)
+                model[size++] = data[i];
+        } else if (size < kMax - 8 && operation < 50) {
+            if (push_head(list, value)) {
+                for (int i = size; i > 0; i--)
+                    model[i] = model[i - 1];
+                model[0] = value;
+                size++;
+            }
+        } else if (size > 0 && operation < 60) {
+            ok = list.pop_front() == model[0];
+            for (int i = 1; i < size; i++)
+                model[i - 1] = model[i];
+            size--;
+        } else if (size > 0 && operation < 80) {
+            int index = random(size);
+            list.erase_by_index(index);
+            for (int i = index + 1; i < size; i++)
+                model[i - 1] = model[i];
+            size--;
+        } else if (operation < 83) {
+            list.erase_by_value(value);
+            int kept = 0;
+            for (int i = 0; i < size; i++) {
+                if (model[i] != value)
+                    model[kept++] = model[i];
+            }
+            size = kept;
+        } else if (operation < 84) {
+            list.clear();
+            size = 0;
+        } else {
+            ok = list.find(value) == count(value);
+        }
+    }
+    for (int value = 0; value < kValues && ok; value++)
+        ok = list.find(value) == count(value);
+    for (int i = 0; i < size && ok; i++)
+        ok = list.at(i) == model[i];
+    check(ok && list.size() == size, message);
+}
+
+void test_List_ValueIndex() {
+    typedef int DataType;
+    std::hash<DataType> hash;
+    // many data share a hash
+    auto bad_hash = [](const DataType& data) {
+        return static_cast<size_t>(data % 3);
+    };
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    one_list.enable_value_index(hash);
+    check_value_index(one_list, "value index of OneWayList");
+    OneWayList<DataType> one_collide(is_equal<DataType>);
+    one_collide.enable_value_index(bad_hash);
+    check_value_index(one_collide, "value index of OneWayList, collisions");
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    two_list.enable_value_index(hash);
+    two_list.enable_block_index();
+    check_value_index(two_list, "value index of TwoWayList");
+    TwoWayList<DataType> two_collide(is_equal<DataType>);
+    two_collide.enable_value_index(bad_hash);
+    check_value_index(two_collide, "value index of TwoWayList, collisions");
+
+    // the index is built from the items and follows splice_back
+    TwoWayList<DataType> first(is_equal<DataType>);
+    TwoWayList<DataType> second(is_equal<DataType>);
+    int data[] = {1, 2, 2, 3};
+    first.push_range(data, 4);
+    second.push_range(data, 4);
+    first.enable_value_index(hash);
+    second.enable_value_index(hash);
+    first.splice_back(second);
+    check(first.find(2) == 4 && second.find(2) == 0,
+          "value index after splice_back");
+    first.erase_by_value(2);
+    first.push_head(2);
+    check(first.find(2) == 1 && first.find(1) == 2 && first.size() == 5,
+          "value index after erase_by_value and push_head");
+    first.disable_value_index();
+    check(first.find(3) == 2, "find without the value index");
+}
+
+// Compare count_equal with a plain loop for every length up to count
+template<typename T>
+bool check_count_equal(const T* data, int count, T value) {
+    bool ok = true;
+    for (int length = 0; length <= count && ok; length++) {
+        int expected = 0;
+        for (int i = 0; i < length; i++)
+            expected += data[i] == value;
+        ok = count_equal(data, length, value) == expected;
+    }
+    return ok;
+}
+
+void test_List_SimdFind() {
+    const int kCount = 70;
+    char chars[kCount];
+    int16_t shorts[kCount];
+    int ints[kCount];
+    int64_t longs[kCount];
+    float floats[kCount];
+    double doubles[kCount];
+    for (int i = 0; i < kCount; i++) {
+        chars[i] = static_cast<char>(i % 3 - 1);
+        shorts[i] = static_cast<int16_t>(i % 5);
+        ints[i] = i % 7 == 0 ? -1 : i;
+        // the halves of the 64 bit data differ
+        longs[i] = i % 4 == 0 ? 0x100000001ll :
+                   (i % 4 == 1 ? 1 : 0x100000000ll);
+        floats[i] = i % 3 == 0 ? 0.0f : -0.0f;
+        doubles[i] = i % 2 == 0 ? 1.5 :
+                     std::numeric_limits<double>::quiet_NaN();
+    }
+    check(check_count_equal(chars, kCount, static_cast<char>(-1)) &&
+          check_count_equal(shorts, kCount, static_cast<int16_t>(2)) &&
+          check_count_equal(ints, kCount, -1) &&
+          check_count_equal(longs, kCount, static_cast<int64_t>(1)) &&
+          check_count_equal(longs, kCount, static_cast<int64_t>(0x100000001ll)),
+          "count_equal of integers");
+    // more matches than a byte lane can count
+    const int kLong = 20000;
+    std::unique_ptr<char[]> same(new char[kLong]);
+    for (int i = 0; i < kLong; i++)
+        same[i] = 5;
+    check(count_equal(same.get(), kLong, static_cast<char>(5)) == kLong,
+          "count_equal of a long array");
+    check(count_equal(floats, kCount, 0.0f) == kCount &&
+          count_equal(doubles, kCount,
+                      std::numeric_limits<double>::quiet_NaN()) == 0 &&
+          check_count_equal(doubles, kCount, 1.5),
+          "count_equal of floating point data");
+
+    typedef std::equal_to<int> Equal;
+    typedef std::function<bool(const int&, const int&)> Function;
+    static_assert(is_simd_comparable<int, Equal>::value &&
+                  !is_simd_comparable<int, Function>::value &&
+                  !is_simd_comparable<Foo, std::equal_to<Foo>>::value,
+                  "SIMD find is chosen for arithmetic data and std::equal_to");
+    UnrolledList<int, Equal, 16> simd_list((Equal()));
+    UnrolledList<int, Function, 16> plain_list(is_equal<int>);
+    for (int i = 0; i < 1000; i++) {
+        simd_list.push(i % 10);
+        plain_list.push(i % 10);
+    }
+    simd_list.erase_by_index(3);
+    plain_list.erase_by_index(3);
+    simd_list.pop_front();
+    plain_list.pop_front();
+    bool ok = true;
+    for (int value = -1; value <= 10; value++)
+        ok = ok && simd_list.find(value) == plain_list.find(value);
+    check(ok && simd_list.find(5) == 100, "SIMD find of UnrolledList");
+}
+
+// Compare the parallel passes over the list with the single thread ones
+template<typename L>
+bool check_parallel(L& list, ThreadPool& pool) {
+    bool ok = true;
+    for (int value = 0; value < 5; value++)
+        ok = ok && list.parallel_count(pool, value) == list.find(value);
+    int odd = 0;
+    list.apply([&odd](const int& data) {
+        odd += data % 2;
+    });
+    ok = ok && list.parallel_count_if(pool, [](const int& data) {
+        return data % 2 == 1;
+    }) == odd;
+    int64_t sum = 0;
+    list.apply([&sum](const int& data) {
+        sum += data;
+    });
+    std::atomic<int64_t> parallel_sum(0);
+    list.parallel_apply(pool, [&parallel_sum](const int& data) {
+        parallel_sum += data;
+    });
+    return ok && parallel_sum == sum;
+}
+
+void test_List_Parallel() {
+    typedef int DataType;
+    const int kCount = 100000;
+    ThreadPool pool(4);
+    ThreadPool single(1);
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    UnrolledList<DataType> unrolled(is_equal<DataType>);
+    UnrolledList<DataType, std::equal_to<DataType>> simd_list(
+            (std::equal_to<DataType>()));
+    check(check_parallel(one_list, pool) && check_parallel(unrolled, pool),
+          "parallel passes over empty lists");
+    for (int i = 0; i < kCount; i++) {
+        one_list.push(i % 7);
+        two_list.push(i % 7);
+        unrolled.push(i % 7);
+        simd_list.push(i % 7);
+    }
+    check(check_parallel(one_list, pool) && check_parallel(two_list, pool) &&
+          check_parallel(one_list, single),
+          "parallel passes with a temporary block index");
+    one_list.enable_block_index();
+    two_list.enable_block_index();
+    two_list.push_head(3);
+    for (int i = 0; i < 1000; i++) {
+        one_list.erase_by_index(i * 37);
+        two_list.erase_by_index(i * 41);
+    }
+    one_list.erase_by_value(4);
+    check(check_parallel(one_list, pool) && check_parallel(two_list, pool),
+          "parallel passes with the block index");
+    check(check_parallel(unrolled, pool) && check_parallel(simd_list, pool),
+          "parallel passes over UnrolledList");
+
+    // the tasks are run once each and the first exception is passed on
+    std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[1000]);
+    for (int i = 0; i < 1000; i++)
+        runs[i] = 0;
+    pool.run(1000, [&runs](int task) {
+        runs[task]++;
+    });
+    bool once = true;
+    for (int i = 0; i < 1000; i++)
+        once = once && runs[i] == 1;
+    bool thrown = false;
+    try {
+        pool.run(100, [](int task) {
+            if (task == 42)
+                throw std::runtime_error("task failed");
+        });
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(once && thrown && pool.sum(100, [](int task) {
+        return task;
+    }) == 4950, "thread pool");
+
+    // the runs of several threads sharing the pool do not mix
+    const int kCallers = 4;
+    std::unique_ptr<std::thread[]> callers(new std::thread[kCallers]);
+    std::atomic<int> wrong(0);
+    for (int i = 0; i < kCallers; i++) {
+        callers[i] = std::thread([&pool, &wrong, i]() {
+            for (int j = 0; j < 200; j++) {
+                if (pool.sum(100 + i, [i](int task) { return task + i; }) !=
+                        (99 + i) * (100 + i) / 2 + i * (100 + i))
+                    wrong++;
+            }
+        });
+    }
+    for (int i = 0; i < kCallers; i++)
+        callers[i].join();
+    check(wrong == 0, "thread pool shared by several threads");
+}
+
+void test_StaticQueue() {
+    typedef int DataType;
+    typedef std::equal_to<DataType> Equal;
+    static_assert(!std::is_polymorphic<
+                  StaticQueue<DataType, OneWayList<DataType>>>::value,
+                  "StaticQueue has no vtable");
+    OneWayList<DataType, HeapAllocator, Equal> one_list((Equal()));
+    StaticQueue<DataType, OneWayList<DataType, HeapAllocator, Equal>>
+            one_queue(one_list);
+    int data[] = {2, 3, 4};
+    int taken[4];
+    one_queue.enqueue(1);
+    one_queue.enqueue_bulk(data, 3);
+    bool ok = one_queue.size() == 4 && one_queue.dequeue() == 1 &&
+              one_queue.dequeue_bulk(taken, 4) == 3 && taken[2] == 4 &&
+              one_queue.is_empty();
+    check(ok, "StaticQueue on OneWayList");
+
+    // the calls go to the TwoWayList methods, not to the base ones
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    StaticQueue<DataType, TwoWayList<DataType>> two_queue(two_list);
+    two_queue.enqueue(1);
+    two_queue.enqueue_bulk(data, 3);
+    ok = two_queue.size() == 4 && two_queue.dequeue() == 1 &&
+         two_list.at(0) == 2 && two_queue.dequeue_bulk(taken, 4) == 3 &&
+         taken[2] == 4 && two_queue.is_empty();
+    bool thrown = false;
+    try {
+        two_queue.dequeue();
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(ok && thrown, "StaticQueue on TwoWayList");
+}
+
+// Element of the intrusive lists, it is in a one way and a two way list
+struct Job {
+    int id_;
+    IntrusiveHook<Job> hook_;
+    IntrusiveHookBi<Job> bi_hook_;
+    explicit Job(int id) : id_(id) {
+    }
+};
+
+// The ids of the elements of the list in order
+template<typename L>
+std::string ids(L& list) {
+    std::string result;
+    list.apply([&result](const Job& job) {
+        result += std::to_string(job.id_);
+    });
+    return result;
+}
+
+void test_IntrusiveList() {
+    Job jobs[] = {Job(0), Job(1), Job(2), Job(3), Job(4), Job(5)};
+    IntrusiveOneWayList<Job, &Job::hook_> one_list;
+    IntrusiveTwoWayList<Job, &Job::bi_hook_> two_list;
+    for (Job& job : jobs) {
+        one_list.push(&job);
+        two_list.push(&job);
+    }
+    // the element is in both lists at once
+    bool ok = one_list.erase(&jobs[3]) && !one_list.erase(&jobs[3]) &&
+              one_list.pop_front() == &jobs[0] &&
+              one_list.erase_after(&jobs[4]) == &jobs[5] &&
+              one_list.erase_after(&jobs[4]) == nullptr;
+    one_list.push(&jobs[0]);
+    ok = ok && ids(one_list) == "1240" && one_list.size() == 4 &&
+         one_list.find_if([](const Job& job) {
+             return job.id_ % 2 == 0;
+         }) == 3;
+    check(ok, "IntrusiveOneWayList");
+
+    two_list.erase(&jobs[3]);
+    two_list.erase(&jobs[5]);
+    two_list.push_head(&jobs[5]);
+    ok = two_list.pop_back() == &jobs[4] && two_list.size() == 4 &&
+         ids(two_list) == "5012" && &two_list.get_last() == &jobs[2];
+    std::string reverse;
+    two_list.apply_reverse([&reverse](const Job& job) {
+        reverse += std::to_string(job.id_);
+    });
+    check(ok && reverse == "2105" && ids(one_list) == "1240",
+          "IntrusiveTwoWayList");
+
+    IntrusiveTwoWayList<Job, &Job::bi_hook_> other;
+    other.push(&jobs[3]);
+    other.push(&jobs[4]);
+    two_list.splice_back(other);
+    IntrusiveOneWayList<Job, &Job::hook_> one_other;
+    one_other.push(&jobs[3]);
+    one_list.splice_back(one_other);
+    ok = ids(two_list) == "501234" && other.is_empty() &&
+         ids(one_list) == "12403" && one_other.size() == 0;
+    one_list.clear();
+    two_list.clear();
+    bool thrown = false;
+    try {
+        two_list.pop_front();
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(ok && thrown && one_list.is_empty() &&
+          jobs[4].hook_.next_ == nullptr, "intrusive splice_back and clear");
+}
+
+void test_TwoWayList_Base() {
+    typedef int DataType;
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    // the queue and the base classes see the items of the list
+    Queue<DataType> queue(two_list);
+    List<DataType>& list = two_list;
+    check(queue.is_empty() && list.is_empty(), "empty TwoWayList");
+    queue.enqueue(1);
+    queue.enqueue(2);
+    two_list.push_head(0);
+    queue.enqueue(3);
+    bool ok = !queue.is_empty() && !list.is_empty() &&
+              list.get_first() == 0 && two_list.get_last() == 3 &&
+              queue.size() == 4 && queue.dequeue() == 0 &&
+              queue.dequeue() == 1;
+    check(ok, "Queue over TwoWayList");
+    OneWayList<DataType, HeapAllocator,
+               std::function<bool(const DataType&, const DataType&)>,
+               NoStats, ListItemBi<DataType>>& base = two_list;
+    ok = base.at(1) == 3 && base.find(2) == 1 && base.size() == 2;
+    check(ok, "OneWayList methods of TwoWayList");
+
+    // the OneWayList methods keep the back links
+    base.emplace_back(4);
+    base.emplace_front(1);
+    DataType data[] = {5, 5, 6};
+    base.push_range(data, 3);
+    ok = base.unique() == 1;
+    base.erase_by_index(0);
+    base.erase_by_value(4);
+    TwoWayList<DataType> other(is_equal<DataType>);
+    other.push(7);
+    other.push(8);
+    base.splice_back(other);
+    base.emplace_back(9);
+    ok = ok && base.pop_front() == 2 && two_list.get_last() == 9;
+    int expected[] = {9, 8, 7, 6, 5, 3};
+    for (int value : expected)
+        ok = ok && two_list.pop_back() == value;
+    check(ok && two_list.is_empty(), "TwoWayList changed as OneWayList");
+
+    // pop_back with and without the block index
+    for (int indexed = 0; indexed < 2; indexed++) {
+        TwoWayList<DataType> deque(is_equal<DataType>);
+        if (indexed)
+            deque.enable_block_index();
+        for (int i = 0; i < 200; i++)
+            deque.push(i);
+        ok = deque.at(150) == 150;
+        for (int i = 199; i >= 100; i--)
+            ok = ok && deque.pop_back() == i;
+        for (int i = 0; i < 50; i++)
+            ok = ok && deque.pop_front() == i;
+        deque.push(1000);
+        ok = ok && deque.at(50) == 1000 && deque.at(0) == 50 &&
+             deque.get_last() == 1000 && deque.size() == 51;
+        while (!deque.is_empty())
+            deque.pop_back();
+        bool thrown = false;
+        try {
+            deque.get_last();
+        } catch (std::runtime_error&) {
+            thrown = true;
+        }
+        check(ok && thrown && deque.size() == 0,
+              indexed ? "pop_back with the block index" : "pop_back");
+    }
+}
+
+void test_Deque() {
+    typedef int DataType;
+    TwoWayList<DataType> list(is_equal<DataType>);
+    Deque<DataType> deque(list);
+    deque.push_back(2);
+    deque.push_front(1);
+    deque.push_back(3);
+    deque.push_front(0);
+    bool ok = deque.size() == 4 && deque.front() == 0 && deque.back() == 3 &&
+              deque.pop_back() == 3 && deque.pop_front() == 0 &&
+              deque.pop_back() == 2 && deque.pop_back() == 1 &&
+              deque.is_empty();
+    bool thrown = false;
+    try {
+        deque.pop_back();
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(ok && thrown, "Deque");
+
+    typedef std::function<bool(const Foo&, const Foo&)> FooEqual;
+    TwoWayList<Foo> foo_list(is_equal<Foo>);
+    Deque<Foo, TwoWayList<Foo, HeapAllocator, FooEqual>> foo_deque(foo_list);
+    foo_deque.push_front(Foo(1));
+    foo_deque.push_front(Foo(2));
+    check(foo_deque.pop_back() == Foo(1) && foo_deque.back() == Foo(2),
+          "Deque of Foo");
+}
+
+// Data counting its constructions, copies and moves
+class Counted {
+    int a_;
+    int b_;
+
+ public:
+    static int built;
+    static int copies;
+    static int moves;
+
+    static void reset() {
+        built = copies = moves = 0;
+    }
+
+    Counted(int a, int b) : a_(a), b_(b) {
+        built++;
+    }
+
+    Counted(const Counted& other) : a_(other.a_), b_(other.b_) {
+        copies++;
+    }
+
+    Counted(Counted&& other) : a_(other.a_), b_(other.b_) {
+        moves++;
+    }
+
+    Counted& operator=(const Counted& other) {
+        a_ = other.a_;
+        b_ = other.b_;
+        copies++;
+        return *this;
+    }
+
+    Counted& operator=(Counted&& other) {
+        a_ = other.a_;
+        b_ = other.b_;
+        moves++;
+        return *this;
+    }
+
+    bool operator==(const Counted& rhs) const {
+        return a_ == rhs.a_ && b_ == rhs.b_;
+    }
+
+    int sum() const {
+        return a_ + b_;
+    }
+};
+
+int Counted::built = 0;
+int Counted::copies = 0;
+int Counted::moves = 0;
+
+// Check the counters of Counted and reset them
+bool counted(int built, int copies, int moves) {
+    bool ok = Counted::built == built && Counted::copies == copies &&
+              Counted::moves == moves;
+    Counted::reset();
+    return ok;
+}
+
+void test_List_Emplace() {
+    typedef Counted DataType;
+    Counted::reset();
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    bool ok = one_list.emplace_back(1, 2).sum() == 3 &&
+              one_list.emplace_front(0, 0).sum() == 0 &&
+              counted(2, 0, 0);
+    ok = ok && one_list.pop_front().sum() == 0 && counted(0, 0, 1) &&
+         one_list.get_first().sum() == 3 && one_list.size() == 1;
+    check(ok, "OneWayList builds the data in place");
+
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    two_list.emplace_back(1, 2);
+    two_list.emplace_front(3, 4);
+    ok = counted(2, 0, 0) && two_list.pop_back().sum() == 3 &&
+         two_list.pop_front().sum() == 7 && counted(0, 0, 2);
+    two_list.emplace_back(5, 6);
+    two_list.emplace_front(7, 8);
+    ok = ok && two_list.get_first().sum() == 15 &&
+         two_list.get_last().sum() == 11 && two_list.at(1).sum() == 11;
+    Counted::reset();
+    check(ok, "TwoWayList builds the data in place");
+
+    // push moves the data into the item once, copies only for lvalues
+    Counted data(1, 1);
+    Counted::reset();
+    one_list.push(std::move(data));
+    ok = counted(0, 0, 2);
+    one_list.push(data);
+    ok = ok && counted(0, 1, 1);
+    Counted range[] = {Counted(2, 2), Counted(3, 3)};
+    Counted::reset();
+    one_list.push_range(range, 2);
+    ok = ok && counted(0, 0, 2);
+    Counted taken[] = {Counted(0, 0), Counted(0, 0)};
+    Counted::reset();
+    ok = ok && one_list.pop_range(taken, 2) == 2 && counted(0, 0, 2);
+    check(ok, "push and pop_range do not copy rvalues");
+
+    // Queue builds the data once, StaticQueue and Deque in the item
+    Queue<DataType> queue(one_list);
+    queue.emplace(1, 2);
+    ok = counted(1, 0, 1);
+    while (!queue.is_empty())
+        queue.dequeue();
+    Counted::reset();
+    OneWayList<DataType, HeapAllocator, std::equal_to<DataType>> static_list(
+            (std::equal_to<DataType>()));
+    StaticQueue<DataType, decltype(static_list)> static_queue(static_list);
+    static_queue.emplace(1, 2);
+    ok = ok && counted(1, 0, 0) && static_queue.dequeue().sum() == 3 &&
+         counted(0, 0, 1);
+    Deque<DataType> deque(two_list);
+    deque.emplace_back(1, 0);
+    deque.emplace_front(2, 0);
+    ok = ok && counted(2, 0, 0) && deque.front().sum() == 2 &&
+         deque.back().sum() == 1;
+    check(ok, "Queue, StaticQueue and Deque emplace");
+
+    // the pool allocator builds the data in place too
+    NodePool<OneWayList<DataType, PoolAllocator>::Node> pool;
+    OneWayList<DataType, PoolAllocator> pool_list(is_equal<DataType>, pool);
+    pool_list.emplace_back(1, 2);
+    ok = counted(1, 0, 0) && pool_list.pop_front().sum() == 3 &&
+         counted(0, 0, 1);
+    check(ok, "OneWayList with PoolAllocator builds the data in place");
+}
+
+// Check the statistics of a list with 10 items 0..9 pushed one by one
+template<typename L>
+bool check_list_stats(L& list) {
+    for (int i = 0; i < 10; i++)
+        list.push(i);
+    list.find(3);
+    list.erase_by_index(7);
+    list.erase_by_value(5);
+    list.pop_front();
+    int sum = 0;
+    list.apply([&sum](const int& data) { sum += data; });
+    StatsSnapshot stats = list.stats().snapshot();
+    const OpStats& push = stats[ListOp::kPush];
+    int64_t buckets = 0;
+    for (int i = 0; i < OpStats::kBuckets; i++)
+        buckets += push.latency[i];
+    return push.calls == 10 && buckets == 10 &&
+           push.latency_percentile(0.5) > 0 &&
+           push.latency_percentile(0.5) <= push.latency_percentile(1.0) &&
+           stats[ListOp::kFind].calls == 1 &&
+           stats[ListOp::kFind].traversed == 10 &&
+           stats[ListOp::kEraseByIndex].calls == 1 &&
+           stats[ListOp::kEraseByValue].calls == 1 &&
+           stats[ListOp::kEraseByValue].traversed >= 5 &&
+           stats[ListOp::kPopFront].calls == 1 &&
+           stats[ListOp::kApply].traversed == 7 &&
+           stats[ListOp::kPopBack].calls == 0 &&
+           stats[ListOp::kPopBack].latency_percentile(0.5) == 0 &&
+           stats.peak_length == 10 && sum == 1 + 2 + 3 + 4 + 6 + 8 + 9;
+}
+
+void test_List_Stats() {
+    typedef int DataType;
+    typedef std::function<bool(const DataType&, const DataType&)> Equal;
+    OneWayList<DataType, HeapAllocator, Equal, ListStats> one_list(
+            is_equal<DataType>);
+    bool ok = check_list_stats(one_list) &&
+              one_list.stats().snapshot()[ListOp::kEraseByIndex].traversed ==
+              6;
+    check(ok, "OneWayList statistics");
+
+    // the two way list walks from the nearer end
+    TwoWayList<DataType, HeapAllocator, Equal, ListStats> two_list(
+            is_equal<DataType>);
+    ok = check_list_stats(two_list) &&
+         two_list.stats().snapshot()[ListOp::kEraseByIndex].traversed == 2;
+    two_list.pop_back();
+    two_list.push_head(0);
+    StatsSnapshot stats = two_list.stats().snapshot();
+    ok = ok && stats[ListOp::kPopBack].calls == 1 &&
+         stats[ListOp::kPushFront].calls == 1 &&
+         std::string(op_name(ListOp::kPushFront)) == "push_front";
+    check(ok, "TwoWayList statistics");
+
+    // the block index walks inside one block only
+    OneWayList<DataType, HeapAllocator, Equal, ListStats> indexed(
+            is_equal<DataType>);
+    indexed.enable_block_index();
+    for (int i = 0; i < 1000; i++)
+        indexed.push(i);
+    indexed.erase_by_index(900);
+    ok = indexed.stats().snapshot()[ListOp::kEraseByIndex].max_traversed <
+         32;
+    check(ok, "statistics of the list with the block index");
+
+    OneWayList<DataType> list(is_equal<DataType>);
+    Queue<DataType, ListStats> queue(list);
+    int data[] = {1, 2, 3};
+    queue.enqueue(0);
+    queue.enqueue_bulk(data, 3);
+    queue.dequeue();
+    queue.dequeue();
+    stats = queue.stats().snapshot();
+    ok = stats[ListOp::kEnqueue].calls == 1 &&
+         stats[ListOp::kPushRange].calls == 1 &&
+         stats[ListOp::kDequeue].calls == 2 && stats.peak_length == 4;
+    check(ok, "Queue statistics");
+}
+
+// Record stored in the persistent queue
+struct Record {
+    int id;
+    double value;
+};
+
+// The number of files in the directory
+int count_files(const std::string& directory) {
+    int count = 0;
+    DIR* dir = opendir(directory.c_str());
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.')
+            count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+// Delete the directory with its files
+void remove_directory(const std::string& directory) {
+    DIR* dir = opendir(directory.c_str());
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.')
+            unlink((directory + "/" + entry->d_name).c_str());
+    }
+    closedir(dir);
+    rmdir(directory.c_str());
+}
+
+// Check the next count records from the queue start with the id
+bool check_records(PersistentQueue<Record>* queue, int id, int count) {
+    bool ok = true;
+    for (int i = 0; i < count; i++) {
+        Record record = queue->dequeue();
+        ok = ok && record.id == id + i && record.value == (id + i) * 0.5;
+    }
+    return ok;
+}
+
+void test_PersistentQueue() {
+    char name[] = "/tmp/list_queue_XXXXXX";
+    std::string directory = mkdtemp(name);
+    std::string path = directory + "/queue";
+    {
+        // 4 items in a segment, 10 items take 3 segments
+        PersistentQueue<Record> queue(path, 4);
+        for (int i = 0; i < 10; i++)
+            queue.enqueue(Record{i, i * 0.5});
+        bool ok = queue.size() == 10 && queue.get_first().id == 0 &&
+                  check_records(&queue, 0, 5);
+        queue.consume();
+        ok = ok && queue.size() == 4 && count_files(path) == 3;
+        check(ok, "PersistentQueue keeps the order and deletes read segments");
+
+        bool thrown = false;
+        try {
+            PersistentQueue<Record> other(path, 4);
+        } catch (std::runtime_error&) {
+            thrown = true;
+        }
+        check(thrown, "PersistentQueue is opened once at a time");
+    }
+    {
+        PersistentQueue<Record> queue(path, 4);
+        Record records[7];
+        for (int i = 0; i < 7; i++)
+            records[i] = Record{10 + i, (10 + i) * 0.5};
+        queue.enqueue_bulk(records, 7);
+        Record taken[20];
+        bool ok = queue.size() == 11 && queue.dequeue_bulk(taken, 20) == 11 &&
+                  taken[0].id == 6 && taken[10].id == 16 && queue.is_empty();
+        bool thrown = false;
+        try {
+            queue.get_first();
+        } catch (std::runtime_error&) {
+            thrown = true;
+        }
+        check(ok && thrown, "PersistentQueue reopened");
+    }
+
+    // the killed process loses no added or taken item
+    pid_t child = fork();
+    if (child == 0) {
+        PersistentQueue<Record> queue(path, 16);
+        for (int i = 0; i < 100; i++)
+            queue.enqueue(Record{i, i * 0.5});
+        queue.dequeue();
+        check_records(&queue, 1, 29);
+        kill(getpid(), SIGKILL);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    {
+        PersistentQueue<Record> queue(path, 16);
+        bool ok = WIFSIGNALED(status) && queue.size() == 70 &&
+                  check_records(&queue, 30, 70) && queue.is_empty();
+        check(ok, "PersistentQueue after the process is killed");
+    }
+
+    bool thrown = false;
+    try {
+        PersistentQueue<int> queue(path);
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(thrown, "PersistentQueue of other items fails to open");
+    remove_directory(path);
+    remove_directory(directory);
+}
+
+void test_SpillQueue() {
+    typedef int DataType;
+    char name[] = "/tmp/list_queue_XXXXXX";
+    std::string directory = mkdtemp(name);
+    TwoWayList<DataType> list(is_equal<DataType>);
+    {
+        // 16 items in memory, 4 items in a page
+        SpillQueue<DataType> queue(list, directory, 16, 4);
+        for (int i = 0; i < 100; i++)
+            queue.enqueue(i);
+        bool ok = queue.size() == 100 && list.size() == 16 &&
+                  queue.spilled_pages() == 20 && count_files(directory) == 20;
+        for (int i = 0; i < 100; i++)
+            ok = ok && list.size() <= 16 && queue.dequeue() == i;
+        bool thrown = false;
+        try {
+            queue.dequeue();
+        } catch (std::runtime_error&) {
+            thrown = true;
+        }
+        ok = ok && thrown && queue.is_empty() && count_files(directory) == 0;
+        check(ok, "SpillQueue keeps the order and the memory budget");
+
+        // random adds and takes against a model in an array
+        const int kMax = 5000;
+        std::unique_ptr<int[]> model(new int[kMax]);
+        int first = 0;
+        int last = 0;
+        Random random(2024);
+        ok = true;
+        for (int i = 0; i < kMax * 3 && last < kMax; i++) {
+            // more adds than takes, the queue grows past the budget
+            if (random(5) < 3 || first == last) {
+                int count = random(7) + 1;
+                for (int j = 0; j < count && last < kMax; j++) {
+                    model[last] = last;
+                    queue.enqueue(last++);
+                }
+            } else {
+                ok = ok && queue.dequeue() == model[first++];
+            }
+            ok = ok && queue.size() == last - first && list.size() <= 16;
+        }
+        // the page being read back may be deleted already
+        int files = count_files(directory);
+        ok = ok && files > 0 && files <= queue.spilled_pages() &&
+             files + 1 >= queue.spilled_pages();
+        check(ok, "SpillQueue with random adds and takes");
+    }
+    check(count_files(directory) == 0, "SpillQueue deletes its files");
+    remove_directory(directory);
+}
+
+// Compare the data the pointers point to
+struct PointerLess {
+    bool operator()(const std::unique_ptr<int>& data1,
+                    const std::unique_ptr<int>& data2) const {
+        return *data1 < *data2;
+    }
+};
+
+// Data with a key to sort by and the position it was added at
+struct Keyed {
+    int key;
+    int id;
+
+    bool operator==(const Keyed& rhs) const {
+        return key == rhs.key && id == rhs.id;
+    }
+};
+
+struct KeyLess {
+    bool operator()(const Keyed& data1, const Keyed& data2) const {
+        return data1.key < data2.key;
+    }
+};
+
+// The one way list has no back links
+template<typename L>
+bool check_back_links(L&, int) {
+    return true;
+}
+
+// Check the back links go over count items in the reverse order
+bool check_back_links(TwoWayList<Keyed>& list, int count) {
+    int reversed = 0;
+    bool ok = true;
+    Keyed next = Keyed{std::numeric_limits<int>::max(), 0};
+    list.apply_reverse([&](const Keyed& data) {
+        ok = ok && data.key <= next.key;
+        next = data;
+        reversed++;
+    });
+    return ok && reversed == count && list.get_first() == next;
+}
+
+// Check the list is sorted by key, stable, of count items, with the
+// back links matching, the last item is checked by adding one more
+template<typename L>
+bool check_sorted(L& list, int count) {
+    Keyed prev = Keyed{-1, -1};
+    int seen = 0;
+    bool ok = true;
+    list.apply([&](const Keyed& data) {
+        ok = ok && (data.key > prev.key ||
+                    (data.key == prev.key && data.id > prev.id));
+        prev = data;
+        seen++;
+    });
+    ok = ok && seen == count && list.size() == count &&
+         check_back_links(list, count);
+    Keyed last = Keyed{1000, 1000000 + count};
+    list.push(last);
+    list.apply([&prev](const Keyed& data) { prev = data; });
+    ok = ok && prev == last;
+    list.erase_by_value(last);
+    return ok && list.size() == count;
+}
+
+template<typename L>
+void check_sort(L& list, L& other, const char* message) {
+    Random random(31337);
+    list.sort(KeyLess());
+    for (int i = 0; i < 1000; i++)
+        list.push(Keyed{random(100), i});
+    list.enable_block_index();
+    list.at(500);
+    list.sort(KeyLess());
+    bool ok = check_sorted(list, 1000) && list.at(0).key == 0 &&
+              list.at(999).key == 99;
+
+    // the other list goes after the items of this list on equal keys
+    for (int i = 0; i < 500; i++)
+        other.push(Keyed{random(100), 1000 + i});
+    other.sort(KeyLess());
+    list.merge(std::move(other), KeyLess());
+    ok = ok && other.is_empty() && other.size() == 0 &&
+         check_sorted(list, 1500) && list.at(1499).key == 99;
+    list.push(Keyed{1000, 1500});
+    ok = ok && check_sorted(list, 1501) && list.at(1500).id == 1500;
+
+    // only the keys are compared, each key stays once
+    list.sort([](const Keyed& data1, const Keyed& data2) {
+        return data1.key > data2.key;
+    });
+    list.apply([](Keyed& data) { data.id = 0; });
+    int erased = list.unique();
+    int count = 0;
+    list.apply([&count](const Keyed&) { count++; });
+    ok = ok && erased == 1501 - 101 && list.size() == 101 && count == 101 &&
+         list.at(100).key == 0 && list.get_first().key == 1000;
+    check(ok, message);
+}
+
+void test_List_Sort() {
+    typedef Keyed DataType;
+    OneWayList<DataType> one_list(is_equal<DataType>);
+    OneWayList<DataType> one_other(is_equal<DataType>);
+    check_sort(one_list, one_other, "OneWayList sort, merge and unique");
+    TwoWayList<DataType> two_list(is_equal<DataType>);
+    TwoWayList<DataType> two_other(is_equal<DataType>);
+    check_sort(two_list, two_other, "TwoWayList sort, merge and unique");
+
+    // the value index follows the new order
+    TwoWayList<int> indexed(is_equal<int>);
+    indexed.enable_value_index([](const int& data) {
+        return static_cast<size_t>(data);
+    });
+    int data[] = {3, 1, 3, 2, 1, 3};
+    indexed.push_range(data, 6);
+    indexed.sort();
+    indexed.erase_by_value(1);
+    int items[8];
+    bool ok = collect(indexed, items, 8) == 4 && items[0] == 2 &&
+              items[3] == 3 && indexed.find(3) == 3 && indexed.unique() == 2 &&
+              indexed.find(3) == 1 && indexed.get_last() == 3;
+    check(ok, "sort with the value index");
+
+    // the items are relinked, not copied or moved
+    OneWayList<Counted> counted_list(is_equal<Counted>);
+    for (int i = 0; i < 100; i++)
+        counted_list.emplace_back(100 - i, 0);
+    Counted::reset();
+    counted_list.sort([](const Counted& data1, const Counted& data2) {
+        return data1.sum() < data2.sum();
+    });
+    ok = counted(0, 0, 0) && counted_list.get_first().sum() == 1;
+    check(ok, "sort does not copy or move the data");
+
+    // move-only data
+    OneWayList<std::unique_ptr<int>> pointers(
+            [](const std::unique_ptr<int>& data1,
+               const std::unique_ptr<int>& data2) {
+                return *data1 == *data2;
+            });
+    for (int i = 0; i < 10; i++)
+        pointers.push(std::make_unique<int>(i % 3));
+    pointers.sort(PointerLess());
+    ok = pointers.unique() == 7 && pointers.size() == 3 &&
+         *pointers.at(2) == 2;
+    check(ok, "sort and unique of move-only data");
+}
+
+void test_PriorityQueue() {
+    PriorityQueue<int> queue;
+    int data[] = {5, 1, 9, 3, 7, 3};
+    queue.enqueue_bulk(data, 6);
+    bool ok = queue.size() == 6 && queue.get_first() == 9;
+    const int expected[] = {9, 7, 5, 3, 3, 1};
+    for (int value : expected)
+        ok = ok && queue.dequeue() == value;
+    bool thrown = false;
+    try {
+        queue.dequeue();
+    } catch (std::runtime_error&) {
+        thrown = true;
+    }
+    check(ok && thrown && queue.is_empty(), "PriorityQueue");
+
+    // random data come out sorted, the smallest first
+    PriorityQueue<int, std::greater<int>> min_queue;
+    Random random(777);
+    for (int i = 0; i < 10000; i++)
+        min_queue.enqueue(random(1000));
+    int last = -1;
+    ok = true;
+    for (int i = 0; i < 5000; i++) {
+        int value = min_queue.dequeue();
+        ok = ok && value >= last;
+        last = value;
+    }
+    min_queue.enqueue(-5);
+    ok = ok && min_queue.dequeue() == -5 && min_queue.size() == 5000;
+    check(ok, "PriorityQueue of random data");
+
+    // the items are moved, not copied
+    PriorityQueue<std::unique_ptr<int>, PointerLess> pointers;
+    for (int i = 0; i < 40; i++)
+        pointers.enqueue(std::make_unique<int>(i % 20));
+    ok = *pointers.dequeue() == 19 && *pointers.dequeue() == 19 &&
+         *pointers.dequeue() == 18 && pointers.size() == 37;
+    check(ok, "PriorityQueue of move-only items");
+}
+
+void test_BlockingQueue() {
+    typedef int DataType;
+    OneWayList<DataType> list(is_equal<DataType>);
+    BlockingQueue<DataType> queue(list, 4);
+    int data = 0;
+    bool ok = !queue.try_pop(&data) &&
+              !queue.pop_for(&data, std::chrono::milliseconds(5));
+    check(ok, "empty BlockingQueue times out");
+    int items[] = {1, 2, 3};
+    ok = queue.push_bulk(items, 3) == 3 && queue.push(4) &&
+         queue.size() == 4 && queue.try_pop(&data) && data == 1 &&
+         queue.pop(&data) && data == 2;
+    int taken[4];
+    ok = ok && queue.pop_bulk(taken, 4) == 2 && taken[0] == 3 &&
+         taken[1] == 4 && queue.size() == 0;
+    check(ok, "BlockingQueue keeps the order");
+
+    // a full queue blocks the producer until a consumer takes an item
+    for (int i = 0; i < 4; i++)
+        queue.push(i);
+    std::atomic<bool> pushed(false);
+    std::thread producer([&queue, &pushed]() {
+        queue.push(4);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ok = !pushed.load() && queue.size() == 4;
+    ok = ok && queue.pop(&data) && data == 0;
+    producer.join();
+    ok = ok && pushed.load() && queue.size() == 4;
+    check(ok, "full BlockingQueue applies backpressure");
+
+    // close wakes the waiting consumers, the items can still be taken
+    std::thread consumer([&queue, &ok]() {
+        int data = 0;
+        int count = 0;
+        while (queue.pop(&data))
+            count++;
+        ok = ok && count == 4;
+    });
+    queue.close();
+    consumer.join();
+    ok = ok && queue.is_closed() && !queue.push(5) && !queue.pop(&data) &&
+         !queue.pop_for(&data, std::chrono::seconds(10));
+    check(ok, "closed BlockingQueue");
+
+    // several producers and consumers, every item passes exactly once
+    const int threads = 4;
+    const int count = 20000;
+    OneWayList<DataType> shared_list(is_equal<DataType>);
+    BlockingQueue<DataType> shared(shared_list, 64);
+    std::atomic<int64_t> sum(0);
+    std::atomic<int> passed(0);
+    std::unique_ptr<std::thread[]> producers(new std::thread[threads]);
+    std::unique_ptr<std::thread[]> consumers(new std::thread[threads]);
+    for (int t = 0; t < threads; t++) {
+        producers[t] = std::thread([&shared, t]() {
+            int batch[10];
+            for (int i = 0; i < count; i += 10) {
+                for (int j = 0; j < 10; j++)
+                    batch[j] = t * count + i + j;
+                if (t % 2 == 0)
+                    shared.push_bulk(batch, 10);
+                else
+                    for (int j = 0; j < 10; j++)
+                        shared.push(batch[j]);
+            }
+        });
+        consumers[t] = std::thread([&shared, &sum, &passed, t]() {
+            int batch[8];
+            while (true) {
+                int taken = t % 2 == 0 ? shared.pop_bulk(batch, 8) :
+                                         shared.pop(batch) ? 1 : 0;
+                if (taken == 0)
+                    break;
+                for (int j = 0; j < taken; j++)
+                    sum += batch[j];
+                passed += taken;
+            }
+        });
+    }
+    for (int t = 0; t < threads; t++)
+        producers[t].join();
+    shared.close();
+    for (int t = 0; t < threads; t++)
+        consumers[t].join();
+    int64_t total = static_cast<int64_t>(threads) * count;
+    check(passed.load() == total && sum.load() == total * (total - 1) / 2,
+          "BlockingQueue passes every item exactly once");
+}
+
 int main() {
     std::cout << "------ test_QueueInt_OneWayList ------" << std::endl;
     test_QueueInt_OneWayList();
@@ -359,5 +2256,64 @@ int main() {
     test_OneWayList_Pointer();
     std::cout << "------ test_TwoWayList_Pointer ------" << std::endl;
     test_TwoWayList_Pointer();
-    return 0;
+
+    std::cout << "------ test_OneWayList_Tail ------" << std::endl;
+    test_OneWayList_Tail();
+    std::cout << "------ test_List_Clear ------" << std::endl;
+    test_List_Clear();
+    std::cout << "------ test_List_DestroyLong ------" << std::endl;
+    test_List_DestroyLong();
+    std::cout << "------ test_List_NodePool ------" << std::endl;
+    test_List_NodePool();
+    std::cout << "------ test_ConcurrentQueue ------" << std::endl;
+    test_ConcurrentQueue();
+    std::cout << "------ test_ConcurrentQueue_Threads ------" << std::endl;
+    test_ConcurrentQueue_Threads();
+    std::cout << "------ test_RingBuffer ------" << std::endl;
+    test_RingBuffer();
+    std::cout << "------ test_RingBuffer_Threads ------" << std::endl;
+    test_RingBuffer_Threads();
+    std::cout << "------ test_List_Visitors ------" << std::endl;
+    test_List_Visitors();
+    std::cout << "------ test_List_Iterators ------" << std::endl;
+    test_List_Iterators();
+    std::cout << "------ test_UnrolledList ------" << std::endl;
+    test_UnrolledList();
+    std::cout << "------ test_List_PopFront ------" << std::endl;
+    test_List_PopFront();
+    std::cout << "------ test_List_Bulk ------" << std::endl;
+    test_List_Bulk();
+    std::cout << "------ test_List_Size ------" << std::endl;
+    test_List_Size();
+    std::cout << "------ test_List_BlockIndex ------" << std::endl;
+    test_List_BlockIndex();
+    std::cout << "------ test_List_ValueIndex ------" << std::endl;
+    test_List_ValueIndex();
+    std::cout << "------ test_List_SimdFind ------" << std::endl;
+    test_List_SimdFind();
+    std::cout << "------ test_List_Parallel ------" << std::endl;
+    test_List_Parallel();
+    std::cout << "------ test_StaticQueue ------" << std::endl;
+    test_StaticQueue();
+    std::cout << "------ test_IntrusiveList ------" << std::endl;
+    test_IntrusiveList();
+    std::cout << "------ test_TwoWayList_Base ------" << std::endl;
+    test_TwoWayList_Base();
+    std::cout << "------ test_Deque ------" << std::endl;
+    test_Deque();
+    std::cout << "------ test_PriorityQueue ------" << std::endl;
+    test_PriorityQueue();
+    std::cout << "------ test_List_Emplace ------" << std::endl;
+    test_List_Emplace();
+    std::cout << "------ test_List_Stats ------" << std::endl;
+    test_List_Stats();
+    std::cout << "------ test_BlockingQueue ------" << std::endl;
+    test_BlockingQueue();
+    std::cout << "------ test_PersistentQueue ------" << std::endl;
+    test_PersistentQueue();
+    std::cout << "------ test_SpillQueue ------" << std::endl;
+    test_SpillQueue();
+    std::cout << "------ test_List_Sort ------" << std::endl;
+    test_List_Sort();
+    return failures == 0 ? 0 : 1;
 }